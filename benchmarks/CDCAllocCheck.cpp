@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Check of realtime mode. Global allocator counts allocations made by
+ * the sending thread and by the reading thread of CDCImpl during sustained
+ * DS, S and DR traffic with simulated device. Exits with 1, if any
+ * allocation occurs after warm-up.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCImpl.h>
+#include <CDCSimulator.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// allocations are counted only in threads of CDCImpl
+static thread_local bool countedThread = false;
+static std::atomic<bool> counting(false);
+static std::atomic<unsigned long long> allocations(0);
+
+void* operator new(size_t size)
+{
+    if (countedThread && counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void* ptr = malloc((size == 0)? 1 : size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// sends DS and S commands
+static bool sendCommands(CDCImpl& cdc, unsigned int count)
+{
+    unsigned char dpaRequest[40] = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    for (unsigned int i = 0; i < count; i++) {
+        CDCResult<DSResponse> response = cdc.trySendData(dpaRequest, sizeof(dpaRequest));
+        if (!response || response.value() != OK)
+            return false;
+        if (!cdc.tryGetStatus())
+            return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    SimulatorOptions simulatorOptions;
+    simulatorOptions.asyncRate = 2000;
+    simulatorOptions.asyncLength = 60;
+    simulatorOptions.dpaResponses = true;
+    CDCSimulator simulator(simulatorOptions);
+
+    CDCImplOptions options;
+    options.realtime = true;
+    CDCImpl cdc(simulator.createTransport(), options);
+
+    // the listener marks the reading thread
+    std::atomic<unsigned long long> asyncMessages(0);
+    cdc.addAsyncMsgListener([&asyncMessages](unsigned char*, unsigned int) {
+        countedThread = true;
+        asyncMessages++;
+    });
+
+    countedThread = true;
+    if (!sendCommands(cdc, 200)) {
+        printf("Warm-up failed\n");
+        return 1;
+    }
+
+    counting = true;
+    bool sent = sendCommands(cdc, 5000);
+    counting = false;
+
+    CDCMetrics metrics = cdc.getMetrics();
+    printf("Commands: %s, DR messages: %llu, allocations: %llu, pool misses: %llu\n",
+        sent? "OK" : "failed", asyncMessages.load(), allocations.load(), metrics.poolMisses);
+
+    return (sent && allocations == 0)? 0 : 1;
+}
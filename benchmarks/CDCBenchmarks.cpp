@@ -0,0 +1,441 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Benchmarks of message parsing and command-response cycle. Results
+ * are printed in JSON format, unless --benchmark_format is specified.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <CDCMessageParser.h>
+#include <CDCTypes.h>
+
+#ifndef WIN32
+#include <CDCImpl.h>
+#include <CDCImplPri.h>
+#include <CDCSimulator.h>
+#include <CDCTransactions.h>
+
+#include <poll.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+/*
+ * For converting string literals to unsigned string literals.
+ */
+inline const unsigned char* uchar_str(const char* s)
+{
+    return reinterpret_cast<const unsigned char*>(s);
+}
+
+// returns DR message with data of specified length
+ustring asyncMessage(unsigned int length)
+{
+    ustring msg(uchar_str("<DR"));
+    msg.append(1, static_cast<unsigned char>(length));
+    msg.append(1, ':');
+    for (unsigned int i = 0; i < length; i++)
+        msg.append(1, static_cast<unsigned char>(i));
+    msg.append(1, 0x0D);
+    return msg;
+}
+
+// returns response with specified header and binary data
+ustring dataMessage(const char* header, unsigned int length)
+{
+    ustring msg(uchar_str(header));
+    for (unsigned int i = 0; i < length; i++)
+        msg.append(1, static_cast<unsigned char>(i + 1));
+    msg.append(1, 0x0D);
+    return msg;
+}
+
+// returns SPI status response
+ustring statusMessage(void)
+{
+    ustring msg(uchar_str("<S:"));
+    msg.append(1, static_cast<unsigned char>(READY_COMM));
+    msg.append(1, 0x0D);
+    return msg;
+}
+
+
+/* --- PARSER */
+static void BM_ParseData(benchmark::State& state, ustring msg)
+{
+    CDCMessageParser parser;
+    for (auto _ : state) {
+        ParseResult result = parser.parseData(msg);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * msg.size());
+}
+
+BENCHMARK_CAPTURE(BM_ParseData, test, ustring(uchar_str("<OK\r")));
+BENCHMARK_CAPTURE(BM_ParseData, reset_tr, ustring(uchar_str("<RT:OK\r")));
+BENCHMARK_CAPTURE(BM_ParseData, data_send, ustring(uchar_str("<DS:OK\r")));
+BENCHMARK_CAPTURE(BM_ParseData, spi_status, statusMessage());
+// special state 17
+BENCHMARK_CAPTURE(BM_ParseData, usb_info, ustring(uchar_str("<I:GW-USB-SIM#01.00#0123ABCD\r")));
+// special state 21
+BENCHMARK_CAPTURE(BM_ParseData, tr_info_standard, dataMessage("<IT:", 16));
+BENCHMARK_CAPTURE(BM_ParseData, tr_info_extended, dataMessage("<IT:", 32));
+// special state 95
+BENCHMARK_CAPTURE(BM_ParseData, upload_response, ustring(uchar_str("<PM:OK\r")));
+BENCHMARK_CAPTURE(BM_ParseData, download_data, dataMessage("<PM:", 32));
+
+// special state 50
+static void BM_ParseAsyncData(benchmark::State& state)
+{
+    CDCMessageParser parser;
+    ustring msg = asyncMessage(static_cast<unsigned int>(state.range(0)));
+    for (auto _ : state) {
+        ParseResult result = parser.parseData(msg);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(state.iterations() * msg.size());
+}
+
+BENCHMARK(BM_ParseAsyncData)->Arg(8)->Arg(64)->Arg(255);
+
+// incomplete message is parsed again after each chunk from port
+static void BM_ParseIncomplete(benchmark::State& state)
+{
+    CDCMessageParser parser;
+    ustring msg = asyncMessage(64);
+    msg.resize(msg.size() / 2);
+    for (auto _ : state) {
+        ParseResult result = parser.parseData(msg);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(BM_ParseIncomplete);
+
+#ifndef WIN32
+
+/* --- IMPLEMENTATION */
+// number of processed asynchronous messages
+static unsigned long long asyncMessages = 0;
+
+static void receiveData(unsigned char* data, unsigned int length)
+{
+    benchmark::DoNotOptimize(data);
+    (void)length;
+    asyncMessages++;
+}
+
+static void BM_CommandToBuffer(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImplPrivate impl(simulator.createTransport());
+
+    ustring data;
+    for (int i = 0; i < state.range(0); i++)
+        data.append(1, static_cast<unsigned char>(i));
+
+    for (auto _ : state) {
+        CDCImplPrivate::Command cmd = impl.constructCommand(MSG_DATA_SEND, data);
+        CDCImplPrivate::BuffCommand buffCmd = impl.commandToBuffer(cmd);
+        benchmark::DoNotOptimize(buffCmd);
+    }
+}
+
+BENCHMARK(BM_CommandToBuffer)->Arg(0)->Arg(16)->Arg(64)->Arg(255);
+
+// burst of DR messages with responses between them, as read from port
+static void BM_ProcessAllMessages(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImplPrivate impl(simulator.createTransport());
+    impl.setAsyncListener(&receiveData);
+
+    ustring burst;
+    for (int i = 0; i < state.range(0); i++) {
+        if (i % 8 == 7)
+            burst.append((i % 16 == 7)? ustring(uchar_str("<DS:OK\r")) : statusMessage());
+        else
+            burst.append(asyncMessage(10 + (i % 4) * 16));
+    }
+
+    for (auto _ : state) {
+        FrameBytes msgBuffer(burst.data(), burst.size());
+        impl.processAllMessages(msgBuffer);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * burst.size());
+
+    impl.setAsyncListener(NULL);
+}
+
+BENCHMARK(BM_ProcessAllMessages)->Arg(16)->Arg(64)->Arg(1024);
+
+// DR messages dispatched to many listeners filtered by PNUM
+static void BM_DispatchFiltered(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImplPrivate impl(simulator.createTransport());
+
+    // data of asyncMessage start with 00 01 02, i.e. PNUM 2
+    std::vector<unsigned int> listenerIds;
+    for (int i = 0; i < state.range(0); i++) {
+        AsyncMsgFilter filter(AsyncMsgFilter::ANY, i % 256);
+        listenerIds.push_back(impl.addAsyncListener(&receiveData, filter));
+    }
+
+    ustring burst;
+    for (int i = 0; i < 16; i++)
+        burst.append(asyncMessage(10 + (i % 4) * 16));
+
+    for (auto _ : state) {
+        FrameBytes msgBuffer(burst.data(), burst.size());
+        impl.processAllMessages(msgBuffer);
+    }
+    state.SetItemsProcessed(state.iterations() * 16);
+
+    for (unsigned int listenerId : listenerIds)
+        impl.removeAsyncListener(listenerId);
+}
+
+BENCHMARK(BM_DispatchFiltered)->Arg(1)->Arg(16)->Arg(256);
+
+// full command-response cycle through pseudo-terminal
+static void BM_SendDataRoundTrip(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    const unsigned char dpaRequest[] = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    for (auto _ : state) {
+        DSResponse response = cdc.sendData(dpaRequest, sizeof(dpaRequest));
+        if (response != OK) {
+            state.SkipWithError("Data send failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SendDataRoundTrip)->UseRealTime();
+
+// specified count of DS commands sent by single write, one wakeup
+static void BM_SendDataBatch(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    const ustring dpaRequest = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    std::vector<ustring> frames(state.range(0), dpaRequest);
+    for (auto _ : state) {
+        std::vector<CDCResult<DSResponse>> results = cdc.sendDataBatch(frames);
+        if (std::any_of(results.begin(), results.end(),
+                [](const CDCResult<DSResponse>& result) { return !result || result.value() != OK; })) {
+            state.SkipWithError("Data send failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SendDataBatch)->Arg(1)->Arg(8)->Arg(32)->UseRealTime();
+
+// DS round trip with busy polling for specified time [us], 0 disables it
+static void BM_BusyPollRoundTrip(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    BusyPollOptions busyPoll;
+    busyPoll.enabled = (state.range(0) > 0);
+    busyPoll.spinTime = static_cast<unsigned int>(state.range(0));
+    cdc.setBusyPoll(busyPoll);
+
+    const unsigned char dpaRequest[] = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    for (auto _ : state) {
+        DSResponse response = cdc.sendData(dpaRequest, sizeof(dpaRequest));
+        if (response != OK) {
+            state.SkipWithError("Data send failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    CDCMetrics metrics = cdc.getMetrics();
+    if (metrics.responses > 0) {
+        state.counters["latency_us"] = static_cast<double>(metrics.responseLatency) / metrics.responses;
+        state.counters["spin_us"] = static_cast<double>(metrics.spinTime) / metrics.responses;
+    }
+}
+
+BENCHMARK(BM_BusyPollRoundTrip)->Arg(0)->Arg(50)->Arg(200)->UseRealTime();
+
+// DS command sent and its response read by the benchmark thread
+static void BM_EventLoopRoundTrip(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImplOptions options;
+    options.eventLoop = true;
+    CDCImpl cdc(simulator.createTransport(), options);
+
+    struct pollfd pollFd;
+    pollFd.fd = cdc.getPollHandle();
+    pollFd.events = POLLIN;
+
+    const ustring dpaRequest = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    bool finished = false;
+    CDCResult<DSResponse> result = CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+    DataSendCallbackF callback = [&](const CDCResult<DSResponse>& response) {
+        result = response;
+        finished = true;
+    };
+
+    for (auto _ : state) {
+        finished = false;
+        cdc.sendDataAsync(dpaRequest, callback);
+        while (!finished) {
+            if (poll(&pollFd, 1, cdc.getTimerTimeout()) > 0)
+                cdc.onReadable();
+            cdc.onTimer();
+        }
+        if (!result.ok()) {
+            state.SkipWithError("Data send failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EventLoopRoundTrip)->UseRealTime();
+
+// DPA request and its response matched by transaction layer
+static void BM_TransactionRoundTrip(benchmark::State& state)
+{
+    SimulatorOptions options;
+    options.dpaResponses = true;
+    CDCSimulator simulator(options);
+    CDCImpl cdc(simulator.createTransport());
+    CDCTransactions transactions(cdc);
+
+    const ustring dpaRequest = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+    for (auto _ : state) {
+        TransactionResult result = transactions.send(dpaRequest, 1000).get();
+        if (result.status != TransactionStatus::OK) {
+            state.SkipWithError("Transaction failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TransactionRoundTrip)->UseRealTime();
+
+// status query through pseudo-terminal
+static void BM_GetStatusRoundTrip(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    for (auto _ : state) {
+        SPIStatus spiStatus = cdc.getStatus();
+        benchmark::DoNotOptimize(spiStatus);
+    }
+}
+
+BENCHMARK(BM_GetStatusRoundTrip)->UseRealTime();
+
+// status read from cache refreshed by monitor thread
+static void BM_GetCachedStatus(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+    cdc.getStatus();
+    cdc.startStatusMonitor(10);
+
+    for (auto _ : state) {
+        CDCResult<SPIStatus> spiStatus = cdc.getCachedStatus();
+        benchmark::DoNotOptimize(spiStatus);
+    }
+
+    cdc.stopStatusMonitor();
+}
+
+BENCHMARK(BM_GetCachedStatus);
+
+// expected failure reported by exception
+static void BM_SendDataErrorThrow(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    const unsigned char tooLargeData[UCHAR_MAX + 1] = { 0 };
+    for (auto _ : state) {
+        try {
+            cdc.sendData(tooLargeData, sizeof(tooLargeData));
+        } catch (CDCSendException& e) {
+            benchmark::DoNotOptimize(e.what());
+        }
+    }
+}
+
+BENCHMARK(BM_SendDataErrorThrow);
+
+// expected failure reported by error code
+static void BM_SendDataErrorCode(benchmark::State& state)
+{
+    CDCSimulator simulator;
+    CDCImpl cdc(simulator.createTransport());
+
+    const unsigned char tooLargeData[UCHAR_MAX + 1] = { 0 };
+    for (auto _ : state) {
+        CDCResult<DSResponse> result = cdc.trySendData(tooLargeData, sizeof(tooLargeData));
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(BM_SendDataErrorCode);
+
+#endif
+
+int main(int argc, char** argv)
+{
+    // JSON output is default
+    std::vector<char*> args(argv, argv + argc);
+    char jsonFormat[] = "--benchmark_format=json";
+    bool formatSpecified = false;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--benchmark_format", strlen("--benchmark_format")) == 0)
+            formatSpecified = true;
+    }
+    if (!formatSpecified)
+        args.insert(args.begin() + 1, jsonFormat);
+
+    int argCount = static_cast<int>(args.size());
+    benchmark::Initialize(&argCount, args.data());
+    if (benchmark::ReportUnrecognizedArguments(argCount, args.data()))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
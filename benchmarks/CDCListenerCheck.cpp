@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Check of changing asynchronous listeners from their callbacks in event
+ * loop mode. A listener removes itself and adds another one, which removes
+ * itself too. Exits with 1, if the listeners are not called as expected,
+ * or if the dispatching hangs.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCImpl.h>
+#include <CDCSimulator.h>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+int main(void)
+{
+    SimulatorOptions simulatorOptions;
+    simulatorOptions.asyncRate = 200;
+    CDCSimulator simulator(simulatorOptions);
+
+    CDCImplOptions options;
+    options.eventLoop = true;
+    CDCImpl cdc(simulator.createTransport(), options);
+
+    // hanging dispatch does not return to the loop
+    std::atomic<bool> finished(false);
+    std::thread watchdog([&finished] {
+        for (int i = 0; i < 100 && !finished; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (!finished) {
+            printf("Dispatching hangs\n");
+            fflush(stdout);
+            _exit(1);
+        }
+    });
+
+    unsigned int firstCalls = 0;
+    unsigned int secondCalls = 0;
+    unsigned int firstId = 0;
+    unsigned int secondId = 0;
+    firstId = cdc.addAsyncMsgListener([&](unsigned char*, unsigned int) {
+        firstCalls++;
+        cdc.removeAsyncMsgListener(firstId);
+        secondId = cdc.addAsyncMsgListener([&](unsigned char*, unsigned int) {
+            secondCalls++;
+            cdc.removeAsyncMsgListener(secondId);
+        });
+    });
+
+    struct pollfd pollFd;
+    pollFd.fd = cdc.getPollHandle();
+    pollFd.events = POLLIN;
+
+    // both listeners get one message each, further messages get none
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (poll(&pollFd, 1, 10) > 0)
+            cdc.onReadable();
+    }
+
+    finished = true;
+    watchdog.join();
+
+    printf("First listener: %u calls, second listener: %u calls\n", firstCalls, secondCalls);
+    return (firstCalls == 1 && secondCalls == 1)? 0 : 1;
+}
@@ -1,6 +1,8 @@
 #include "com_microrisc_CDC_J_CDCImpl.h"
 #include <CDCImpl.h>
 #include <fstream>
+#include <map>
+#include <mutex>
 
 #include <iostream>
 #ifdef _DEBUG
@@ -18,9 +20,20 @@
 static JavaVM* jvm = NULL;
 
 /**
- * Global reference to J_CDCImpl object.
+ * Global references to J_CDCImpl objects - Java peers of CDCImpl objects.
  */
-static jobject jCDC = NULL;
+static std::map<CDCImpl*, jobject> jPeers;
+static std::mutex jPeersMutex;
+
+/**
+ * Returns global reference to Java peer of specified CDCImpl object.
+ */
+static jobject getJavaPeer(CDCImpl* cdcImp)
+{
+	std::lock_guard<std::mutex> lck(jPeersMutex);
+	std::map<CDCImpl*, jobject>::iterator peerIt = jPeers.find(cdcImp);
+	return (peerIt != jPeers.end())? peerIt->second : NULL;
+}
 
 /**
 * Global references to cdc classes.
@@ -141,14 +154,22 @@ JNIEXPORT jlong JNICALL Java_com_microrisc_cdc_J_1CDCImpl_createCDCImpl
 	
 	// getting pointer to javaVM api
 	if (env->GetJavaVM(&jvm) < 0) {
+		delete cdcImp;
 		return 0;
 	}
 	
-	jCDC = env->NewGlobalRef(jObj);
+	// each CDCImpl object delivers asynchronous messages to its own peer
+	jobject jCDC = env->NewGlobalRef(jObj);
 	if (jCDC == NULL) {
+		delete cdcImp;
 		return 0;
 	}
 
+	{
+		std::lock_guard<std::mutex> lck(jPeersMutex);
+		jPeers[cdcImp] = jCDC;
+	}
+
   DEBUG_TRC(PAR(cdcImp));
   return (jlong)cdcImp;
 }
@@ -156,7 +177,22 @@ JNIEXPORT jlong JNICALL Java_com_microrisc_cdc_J_1CDCImpl_createCDCImpl
 JNIEXPORT void JNICALL Java_com_microrisc_cdc_J_1CDCImpl_destroyCDCImpl
 (JNIEnv* env, jobject jObj, jlong cdcRef) {
 	CDCImpl* cdcImp = (CDCImpl*)cdcRef;
+
+	// reading thread is ended here, so the peer cannot be used by listener anymore
 	delete cdcImp;
+
+	jobject jCDC = NULL;
+	{
+		std::lock_guard<std::mutex> lck(jPeersMutex);
+		std::map<CDCImpl*, jobject>::iterator peerIt = jPeers.find(cdcImp);
+		if (peerIt != jPeers.end()) {
+			jCDC = peerIt->second;
+			jPeers.erase(peerIt);
+		}
+	}
+
+	if (jCDC != NULL)
+		env->DeleteGlobalRef(jCDC);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_microrisc_cdc_J_1CDCImpl_stub_1test
@@ -368,9 +404,10 @@ JNIEXPORT void JNICALL Java_com_microrisc_cdc_J_1CDCImpl_stub_1switchToCustomlon
 }
 
 /**
- * Stub for registered listeners of asynchronous messages.
+ * Stub for registered listeners of asynchronous messages. Delivers
+ * the message to listener of specified J_CDCImpl object.
  */
-void stubListener(unsigned char data[], unsigned int dataLen) {
+void stubListener(jobject jCDC, unsigned char data[], unsigned int dataLen) {
 	JNIEnv* env = NULL;
 	jint attachRes = 0;
 	jobject jListObj = NULL;
@@ -412,7 +449,15 @@ JNIEXPORT void JNICALL Java_com_microrisc_cdc_J_1CDCImpl_stub_1registerAsyncList
 (JNIEnv* env, jobject jObj, jlong cdcRef) {
   DEBUG_TRC(PAR(cdcRef));
 	CDCImpl* cdcImp = (CDCImpl*)cdcRef;
-    cdcImp->registerAsyncMsgListener(stubListener);
+	jobject jCDC = getJavaPeer(cdcImp);
+	if (jCDC == NULL) {
+		env->ThrowNew(classCDCImplException, "Java peer of CDCImpl not found");
+		return;
+	}
+
+	cdcImp->registerAsyncMsgListener([jCDC](unsigned char data[], unsigned int dataLen) {
+		stubListener(jCDC, data, dataLen);
+	});
 }
 
 JNIEXPORT void JNICALL Java_com_microrisc_cdc_J_1CDCImpl_stub_1unregisterAsyncListener
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Awaitable commands example. Several workflows run as coroutines, no
+ * thread is blocked by waiting for responses of the USB device.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCImpl.h>
+#include <CDCAwait.h>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+// number of concurrently running workflows
+const int WORKFLOW_COUNT = 4;
+
+// number of DS commands sent by each workflow
+const int REQUEST_COUNT = 3;
+
+// coroutine, which runs immediately and is not awaited
+struct Workflow {
+    struct promise_type {
+        Workflow get_return_object() { return Workflow(); }
+        std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// counter of running workflows
+std::mutex runningMutex;
+std::condition_variable runningCond;
+int running = 0;
+
+void finishWorkflow()
+{
+    std::lock_guard<std::mutex> lck(runningMutex);
+    running--;
+    runningCond.notify_all();
+}
+
+// gets SPI status and sends DPA requests to the coordinator
+Workflow runWorkflow(CDCImpl& cdc, int id)
+{
+    CDCResult<SPIStatus> status = co_await awaitGetStatus(cdc);
+    if (!status) {
+        std::cout << "Workflow " << id << ": status failed - " << status.message() << "\n";
+        finishWorkflow();
+        co_return;
+    }
+    if (status.value().isDataReady)
+        std::cout << "Workflow " << id << ": data ready " << status.value().DATA_READY << "\n";
+    else
+        std::cout << "Workflow " << id << ": SPI status 0x" << std::hex << status.value().SPI_MODE << std::dec << "\n";
+
+    // read temperature of the coordinator
+    const ustring request = { 0x00, 0x00, 0x0A, 0x00, 0xFF, 0xFF };
+    for (int i = 0; i < REQUEST_COUNT; i++) {
+        CDCResult<DSResponse> response = co_await awaitSendData(cdc, request);
+        if (!response)
+            std::cout << "Workflow " << id << ": DS failed - " << response.message() << "\n";
+        else
+            std::cout << "Workflow " << id << ": DS response " << response.value() << "\n";
+    }
+
+    finishWorkflow();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage" << std::endl;
+        std::cerr << "  AwaitCommandsExample <port-name>" << std::endl << std::endl;
+        std::cerr << "Example" << std::endl;
+        std::cerr << "  AwaitCommandsExample /dev/ttyACM0" << std::endl;
+        return (-1);
+    }
+
+    try {
+        CDCImpl cdc(argv[1]);
+
+        running = WORKFLOW_COUNT;
+        for (int i = 0; i < WORKFLOW_COUNT; i++)
+            runWorkflow(cdc, i);
+
+        // workflows are resumed by the reading thread
+        std::unique_lock<std::mutex> lck(runningMutex);
+        runningCond.wait(lck, [] { return running == 0; });
+    } catch (CDCImplException& e) {
+        std::cout << e.getDescr() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
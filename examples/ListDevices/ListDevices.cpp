@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Discovery of connected USB devices example
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCDiscovery.h>
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    DiscoveryOptions options;
+    std::vector<std::string> portNames;
+
+    // ports to probe can be specified, otherwise all IQRF USB devices are found
+    for (int i = 1; i < argc; i++)
+        portNames.push_back(argv[i]);
+
+    if (portNames.empty()) {
+        portNames = findDevicePorts(options);
+        std::cout << "Found ports: " << portNames.size() << "\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<DiscoveredDevice> devices = probeDevicePorts(portNames, options);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    for (const DiscoveredDevice& device : devices) {
+        std::cout << device.portName << ": " << device.deviceInfo.type
+            << " firmware " << device.deviceInfo.firmwareVersion
+            << " serial number " << device.deviceInfo.serialNumber << "\n";
+    }
+
+    std::cout << "Responding devices: " << devices.size() << " of " << portNames.size()
+        << " probed in " << elapsed.count() << " ms\n";
+    return 0;
+}
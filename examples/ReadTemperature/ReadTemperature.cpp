@@ -23,10 +23,9 @@
  */
 
 #include <CDCImpl.h>
+#include <CDCTransactions.h>
 #include <iostream>
 #include <cstring>
-#include <thread>         // std::this_thread::sleep_for
-#include <chrono>         // std::chrono::seconds
 
 // length of message header
 const unsigned int HEADER_LENGTH = 4;
@@ -172,43 +171,58 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    // register to receiving asynchronous messages
-    AsyncMsgListenerF aml = &receiveData;
-    testImp->registerAsyncMsgListener(&receiveData);
+    // responses are matched with requests, other asynchronous messages
+    // are passed to the listener
+    CDCTransactions* transactions = ant_new CDCTransactions(*testImp);
+    transactions->setUnmatchedListener(&receiveData);
+
+    // busy module does not refuse requests, they are sent again when it is ready
+    PacingOptions pacing;
+    pacing.enabled = true;
+    testImp->setPacing(pacing);
 
     // data to send to USB device
-    const int REQUEST_LENGTH = 6;
-    unsigned char temperatureRequest[REQUEST_LENGTH] = { 0x01, 0x00, 0x0A, 0x00, 0xFF, 0xFF };
+    const ustring temperatureRequest = { 0x01, 0x00, 0x0A, 0x00, 0xFF, 0xFF };
+    const unsigned int RESPONSE_TIMEOUT = 5000;
 
     for ( int sendCounter = 0; sendCounter < 10; sendCounter++ ) {
-        try {
-            // sending read temperature request and checking response of the device
-            DSResponse dsResponse = testImp->sendData(temperatureRequest, REQUEST_LENGTH);
-            if ( dsResponse != OK ) {
-                // bad response processing...
-                std::cout << "Response not OK: " << dsResponse << "\n";
-            }
-        } catch ( CDCSendException& ex ) {
-            std::cout << ex.getDescr() << "\n";
-            // send exception processing...
-        } catch ( CDCReceiveException& ex ) {
-            std::cout << ex.getDescr() << "\n";
-            // receive exception processing...
+        // sending read temperature request and waiting for response of the device
+        TransactionResult result = transactions->send(temperatureRequest, RESPONSE_TIMEOUT).get();
+
+        if ( !result.confirmation.empty() ) {
+            std::cout << "Confirmation received: ";
+            printDataInHex(&result.confirmation[0], result.confirmation.size());
+        }
+
+        switch ( result.status ) {
+        case TransactionStatus::OK:
+            std::cout << "Response received: \n";
+            printResponse(&result.response[0], result.response.size());
+            break;
+        case TransactionStatus::TIMEOUT:
+            std::cout << "No response received\n";
+            break;
+        case TransactionStatus::SEND_FAILED:
+            // bad response or send error processing...
+            if ( result.sendStatus.ok() )
+                std::cout << "Response not OK: " << result.dsResponse << "\n";
+            else
+                std::cout << result.sendStatus.message() << "\n";
+            break;
+        default:
+            break;
         }
 
         // if reception is stopped, is not further possible to send and
         // to receive any next messages
         if ( testImp->isReceptionStopped() ) {
+            delete transactions;
             delete testImp;
             return 1;
         }
-
-        // sending another message and waiting for the answer
-        // we should wait for a while - to give USB device time to get ready
-        // to succesfully process next message
-        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 
+    delete transactions;
     delete testImp;
     return 0;
 }
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Capture and replay of communication with USB device example
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCImpl.h>
+#include <CDCCapture.h>
+#include <CDCReplay.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// number of received asynchronous messages
+std::atomic<unsigned long long> asyncMessages(0);
+
+// number of received bytes of asynchronous messages
+std::atomic<unsigned long long> asyncBytes(0);
+
+void receiveData(unsigned char* data, unsigned int length)
+{
+    (void)data; //silence -Wunused-parameter
+    asyncMessages++;
+    asyncBytes += length;
+}
+
+// compares captured command with specified header
+bool isCommand(const ustring& cmd, const char* header)
+{
+    size_t headerLen = strlen(header);
+    return cmd.size() == headerLen + 2 && cmd.compare(1, headerLen, (const unsigned char*)header) == 0;
+}
+
+// issues the same library call, which has sent the captured command
+void issueCommand(CDCImpl& cdc, const ustring& cmd)
+{
+    if (cmd.size() >= 6 && cmd.compare(0, 3, (const unsigned char*)">DS") == 0) {
+        cdc.sendData(cmd.substr(5, cmd[3]));
+    } else if (cmd.size() >= 5 && cmd.compare(0, 3, (const unsigned char*)">PM") == 0) {
+        ustring outputData;
+        ustring data = cmd.substr(4, cmd.size() - 5);
+        if (cmd[3] & 0x80)
+            cdc.upload(cmd[3], data);
+        else
+            cdc.download(cmd[3], data, outputData);
+    } else if (isCommand(cmd, "")) {
+        cdc.test();
+    } else if (isCommand(cmd, "S")) {
+        cdc.getStatus();
+    } else if (isCommand(cmd, "I")) {
+        DeviceInfo* devInfo = cdc.getUSBDeviceInfo();
+        delete[] devInfo->type;
+        delete[] devInfo->firmwareVersion;
+        delete[] devInfo->serialNumber;
+        delete devInfo;
+    } else if (isCommand(cmd, "IT")) {
+        delete cdc.getTRModuleInfo();
+    } else if (isCommand(cmd, "B")) {
+        cdc.indicateConnectivity();
+    } else if (isCommand(cmd, "R")) {
+        cdc.resetUSBDevice();
+    } else if (isCommand(cmd, "RT")) {
+        cdc.resetTRModule();
+    } else if (isCommand(cmd, "U")) {
+        cdc.switchToCustom();
+    } else if (isCommand(cmd, "PE")) {
+        cdc.enterProgrammingMode();
+    } else if (isCommand(cmd, "PT")) {
+        cdc.terminateProgrammingMode();
+    } else {
+        std::cout << "Unknown captured command of length " << cmd.size() << "\n";
+    }
+}
+
+int record(const char* portName, const char* captureFile, int seconds)
+{
+    CDCImpl cdc(portName);
+    cdc.registerAsyncMsgListener(&receiveData);
+    cdc.startCapture(captureFile);
+
+    cdc.test();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    cdc.stopCapture();
+    std::cout << "Captured asynchronous messages: " << asyncMessages << "\n";
+    return 0;
+}
+
+int replay(const char* captureFile, ReplaySpeed speed)
+{
+    // commands are issued again in the captured order
+    std::vector<ustring> commands;
+    CDCCaptureReader reader(captureFile);
+    CaptureRecord captureRecord;
+    while (reader.next(captureRecord)) {
+        if (captureRecord.direction == CAPTURE_TX)
+            commands.push_back(captureRecord.data);
+    }
+
+    CDCReplay replay(captureFile, speed);
+    CDCImpl cdc(replay.getPortName());
+    cdc.registerAsyncMsgListener(&receiveData);
+
+    replay.start();
+    for (const ustring& cmd : commands) {
+        try {
+            issueCommand(cdc, cmd);
+        } catch ( CDCImplException& ex ) {
+            std::cout << ex.getDescr() << "\n";
+        }
+    }
+    replay.waitForEnd();
+
+    // let the reading thread to process the rest of replayed data
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    ReplayStats stats = replay.getStats();
+    std::cout << "Replayed records: " << stats.rxRecords << " received, "
+        << stats.txRecords << " transmitted (" << stats.txMismatches << " mismatches)\n";
+    std::cout << "Asynchronous messages: " << asyncMessages << " in " << stats.elapsed << " s";
+    if (stats.elapsed > 0)
+        std::cout << " - " << (asyncMessages / stats.elapsed) << " msg/s, "
+            << (asyncBytes / stats.elapsed) << " B/s";
+    std::cout << "\n";
+
+    if (!replay.getLastError().empty()) {
+        std::cout << "Replay error: " << replay.getLastError() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 5 && strcmp(argv[1], "record") == 0) {
+        try {
+            return record(argv[2], argv[3], atoi(argv[4]));
+        } catch ( CDCImplException& e ) {
+            std::cout << e.getDescr() << "\n";
+            return 1;
+        }
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "replay") == 0) {
+        ReplaySpeed speed = ReplaySpeed::RECORDED;
+        if (argc >= 4 && strcmp(argv[3], "max") == 0)
+            speed = ReplaySpeed::MAXIMAL;
+        try {
+            return replay(argv[2], speed);
+        } catch ( CDCImplException& e ) {
+            std::cout << e.getDescr() << "\n";
+            return 1;
+        }
+    }
+
+    std::cerr << "Usage" << std::endl;
+    std::cerr << "  ReplayCaptureExample record <port-name> <capture-file> <seconds>" << std::endl;
+    std::cerr << "  ReplayCaptureExample replay <capture-file> [max]" << std::endl << std::endl;
+    std::cerr << "Example" << std::endl;
+    std::cerr << "  ReplayCaptureExample record /dev/ttyACM0 traffic.cap 60" << std::endl;
+    std::cerr << "  ReplayCaptureExample replay traffic.cap max" << std::endl;
+    return (-1);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Communication with simulated USB device example
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCImpl.h>
+#include <CDCSimulator.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// number of received asynchronous messages
+std::atomic<unsigned long long> asyncMessages(0);
+
+void receiveData(unsigned char* data, unsigned int length)
+{
+    (void)data; //silence -Wunused-parameter
+    (void)length;
+    asyncMessages++;
+}
+
+int main(int argc, char** argv)
+{
+    // count of commands and rate of asynchronous messages
+    unsigned int commands = (argc >= 2)? atoi(argv[1]) : 1000;
+    unsigned int asyncRate = (argc >= 3)? atoi(argv[2]) : 0;
+
+    SimulatorOptions options;
+    options.asyncRate = asyncRate;
+    options.dpaResponses = true;
+
+    try {
+        CDCSimulator simulator(options);
+        CDCImpl cdc(simulator.createTransport());
+        cdc.registerAsyncMsgListener(&receiveData);
+
+        const unsigned char dpaRequest[] = { 0x00, 0x00, 0x06, 0x03, 0xFF, 0xFF };
+        unsigned int failed = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < commands; i++) {
+            if (cdc.sendData(dpaRequest, sizeof(dpaRequest)) != OK)
+                failed++;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // let the reading thread to process the rest of data
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        SimulatorStats stats = simulator.getStats();
+        std::cout << "Commands: " << commands << " (" << failed << " failed) in " << elapsed << " s";
+        if (elapsed > 0)
+            std::cout << " - " << (commands / elapsed) << " cmd/s";
+        std::cout << "\n";
+        std::cout << "Asynchronous messages: " << asyncMessages << " received, "
+            << stats.asyncMessages << " generated, " << stats.droppedMessages << " dropped\n";
+    } catch ( CDCImplException& e ) {
+        std::cout << e.getDescr() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
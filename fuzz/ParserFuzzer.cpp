@@ -0,0 +1,195 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Fuzz target of message parser. Input is treated as data read from
+ * COM-port and it is split into messages the same way as the reading
+ * thread of CDCImpl does. Each parsing step is done in FAST and FSM
+ * modes and any difference of results aborts the run. Data of parsed
+ * messages are passed to the corresponding getParsed* function.
+ * Input starting with byte lower than number of expected responses
+ * selects the response, which CDCImpl expects after sent command,
+ * and the byte is not parsed.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCMessageParser.h>
+#include <CDCMessageParserException.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// maximal number of messages parsed from one input
+static const unsigned int MAX_MESSAGES = 1024;
+
+// responses expected by CDCImpl after IT and PM commands
+static const ParseContext EXPECTED_RESPONSES[] = {
+    ParseContext(MSG_TR_INFO, 0),
+    ParseContext(MSG_TR_INFO, 21),
+    ParseContext(MSG_TR_INFO, 37),
+    ParseContext(MSG_UPLOAD_DOWNLOAD),
+    ParseContext(MSG_DOWNLOAD_DATA, 6),
+    ParseContext(MSG_DOWNLOAD_DATA, 37),
+    ParseContext(MSG_DOWNLOAD_DATA)
+};
+static const unsigned int EXPECTED_RESPONSE_COUNT = sizeof(EXPECTED_RESPONSES) / sizeof(EXPECTED_RESPONSES[0]);
+
+// prints both results and aborts
+static void reportDifference(const ustring& data, const ParseContext& context,
+    const ParseResult& fast, const ParseResult& fsm)
+{
+    fprintf(stderr, "Parser results differ (expected type %d, length %u) on %u bytes:",
+        context.expectedType, context.expectedLength, static_cast<unsigned int>(data.size()));
+    for (size_t i = 0; i < data.size(); i++)
+        fprintf(stderr, " %02X", data[i]);
+    fprintf(stderr, "\n  FAST: result %d, type %d, last position %u\n",
+        fast.resultType, fast.msgType, fast.lastPosition);
+    fprintf(stderr, "  FSM:  result %d, type %d, last position %u\n",
+        fsm.resultType, fsm.msgType, fsm.lastPosition);
+    abort();
+}
+
+// message type is valid only for successfully parsed messages
+static bool isSameResult(const ParseResult& fast, const ParseResult& fsm)
+{
+    if (fast.resultType != fsm.resultType || fast.lastPosition != fsm.lastPosition)
+        return false;
+    return fast.resultType != PARSE_OK || fast.msgType == fsm.msgType;
+}
+
+// calls getParsed* function, which CDCImpl calls for message of specified type
+static void processParsedMessage(CDCMessageParser& parser, MessageType msgType, ustring& message)
+{
+    try {
+        switch (msgType) {
+        case MSG_USB_INFO: {
+            DeviceInfo* devInfo = parser.getParsedDeviceInfo(message);
+            delete[] devInfo->type;
+            delete[] devInfo->firmwareVersion;
+            delete[] devInfo->serialNumber;
+            delete devInfo;
+
+            USBDeviceInfo usbDevInfo;
+            parser.getParsedDeviceInfo(message, usbDevInfo);
+            break;
+        }
+        case MSG_TR_INFO: {
+            delete parser.getParsedModuleInfo(message);
+
+            ModuleInfo modInfo;
+            parser.getParsedModuleInfo(message, modInfo);
+            break;
+        }
+        case MSG_SPI_STAT:
+            parser.getParsedSPIStatus(message);
+            break;
+        case MSG_DATA_SEND:
+            parser.getParsedDSResponse(message);
+            break;
+        case MSG_ASYNC:
+            parser.getParsedDRData(message);
+            break;
+        case MSG_MODE_PROGRAM:
+            parser.getParsedPEResponse(message);
+            break;
+        case MSG_MODE_NORMAL:
+            parser.getParsedPTResponse(message);
+            break;
+        case MSG_UPLOAD_DOWNLOAD:
+            parser.getParsedPMResponse(message);
+            break;
+        case MSG_DOWNLOAD_DATA:
+            parser.getParsedPMData(message);
+            break;
+        default:
+            break;
+        }
+    } catch (CDCMessageParserException&) {
+        // unknown response value is reported by exception
+    }
+}
+
+/*
+ * Returns position of the next message after bad frame, the same way as
+ * findNextMessage of CDCImpl does. Candidate headers are validated by both
+ * parsers, the accepted candidate keeps the corrected header.
+ */
+static size_t findNextMessage(CDCMessageParser& fastParser, CDCMessageParser& fsmParser,
+    ustring& msgBuffer, const ParseContext& context)
+{
+    for (size_t pos = 1; pos < msgBuffer.size(); pos++) {
+        unsigned char header = msgBuffer[pos];
+        if (header != '<' && header != '>')
+            continue;
+
+        msgBuffer[pos] = '<';
+        ustring candidate = msgBuffer.substr(pos);
+        ParseResult fastResult = fastParser.parseData(candidate, context);
+        ParseResult fsmResult = fsmParser.parseData(candidate, context);
+        if (!isSameResult(fastResult, fsmResult))
+            reportDifference(candidate, context, fastResult, fsmResult);
+        if (fastResult.resultType != PARSE_BAD_FORMAT)
+            return pos;
+        msgBuffer[pos] = header;
+    }
+
+    return msgBuffer.size();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static CDCMessageParser fastParser(ParserMode::FAST);
+    static CDCMessageParser fsmParser(ParserMode::FSM);
+
+    ParseContext context;
+    if (size > 0 && data[0] < EXPECTED_RESPONSE_COUNT) {
+        context = EXPECTED_RESPONSES[data[0]];
+        data++;
+        size--;
+    }
+
+    ustring msgBuffer(data, size);
+
+    for (unsigned int i = 0; i < MAX_MESSAGES && !msgBuffer.empty(); i++) {
+        // the same bugfix of fw implementation as in CDCImpl
+        if (msgBuffer[0] == '>')
+            msgBuffer[0] = '<';
+
+        ustring fsmBuffer = msgBuffer;
+        ParseResult fastResult = fastParser.parseData(msgBuffer, context);
+        ParseResult fsmResult = fsmParser.parseData(fsmBuffer, context);
+        if (!isSameResult(fastResult, fsmResult))
+            reportDifference(msgBuffer, context, fastResult, fsmResult);
+
+        if (fastResult.resultType == PARSE_NOT_COMPLETE)
+            break;
+
+        if (fastResult.resultType == PARSE_BAD_FORMAT) {
+            // throw all bytes from the buffer up to next valid message
+            msgBuffer.erase(0, findNextMessage(fastParser, fsmParser, msgBuffer, context));
+            continue;
+        }
+
+        ustring message = msgBuffer.substr(0, fastResult.lastPosition + 1);
+        msgBuffer.erase(0, fastResult.lastPosition + 1);
+        processParsedMessage(fastParser, fastResult.msgType, message);
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Driver of fuzz target for compilers without libFuzzer. Runs the target
+ * on specified corpus files and directories. With -runs=N it also runs
+ * the target on N inputs composed of mutated fragments of valid messages.
+ *
+ * @version     1.0.0
+ * @date        18.10.2026
+ */
+
+#include <CDCTypes.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// runs the target on content of specified file
+static void runFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+}
+
+// returns valid message of random type
+static ustring randomMessage(std::mt19937& random)
+{
+    const char* responses[] = {
+        "<OK\r", "<R:OK\r", "<RT:OK\r", "<B:OK\r", "<U:OK\r", "<DS:OK\r", "<DS:ERR\r",
+        "<DS:BUSY\r", "<PE:OK\r", "<PE:ERR1\r", "<PT:OK\r", "<PM:OK\r", "<PM:ERR3\r",
+        "<PM:BUSY\r", "<ERR\r", "<I:GW-USB-04A#02.01#1A2B3C4D\r"
+    };
+    const unsigned int responseCount = sizeof(responses) / sizeof(responses[0]);
+
+    ustring msg;
+    unsigned int choice = random() % (responseCount + 4);
+    if (choice < responseCount)
+        return ustring(reinterpret_cast<const unsigned char*>(responses[choice]));
+
+    // messages with binary data
+    unsigned int length = 0;
+    switch (choice - responseCount) {
+    case 0:
+        msg = reinterpret_cast<const unsigned char*>("<S:");
+        length = 1;
+        break;
+    case 1:
+        msg = reinterpret_cast<const unsigned char*>("<IT:");
+        length = (random() % 2)? 16 : 32;
+        break;
+    case 2:
+        msg = reinterpret_cast<const unsigned char*>("<PM:");
+        length = (random() % 2)? 1 : 32;
+        break;
+    default:
+        length = random() % 256;
+        msg = reinterpret_cast<const unsigned char*>("<DR");
+        msg.append(1, static_cast<unsigned char>(length));
+        msg.append(1, ':');
+        break;
+    }
+
+    for (unsigned int i = 0; i < length; i++)
+        msg.append(1, static_cast<unsigned char>(random()));
+    msg.append(1, 0x0D);
+    return msg;
+}
+
+// returns sequence of valid messages with random mutations
+static ustring randomInput(std::mt19937& random)
+{
+    ustring input;
+    unsigned int messages = 1 + random() % 8;
+    for (unsigned int i = 0; i < messages; i++)
+        input.append(randomMessage(random));
+
+    unsigned int mutations = random() % 4;
+    for (unsigned int i = 0; i < mutations && !input.empty(); i++) {
+        size_t pos = random() % input.size();
+        switch (random() % 3) {
+        case 0:
+            input[pos] = static_cast<unsigned char>(random());
+            break;
+        case 1:
+            input.erase(pos, 1 + random() % 4);
+            break;
+        default:
+            input.insert(pos, 1, static_cast<unsigned char>(random()));
+            break;
+        }
+    }
+
+    // truncation simulates partially read data
+    if (random() % 4 == 0 && !input.empty())
+        input.resize(random() % input.size());
+
+    // response expected by CDCImpl, see ParserFuzzer.cpp
+    if (random() % 2 == 0)
+        input.insert(input.begin(), static_cast<unsigned char>(random() % 7));
+
+    return input;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long runs = 0;
+    unsigned long seed = std::random_device()();
+    unsigned long files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "-runs=", 6) == 0) {
+            runs = strtoul(argv[i] + 6, NULL, 10);
+            continue;
+        }
+        if (strncmp(argv[i], "-seed=", 6) == 0) {
+            seed = strtoul(argv[i] + 6, NULL, 10);
+            continue;
+        }
+
+        std::filesystem::path path(argv[i]);
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    runFile(entry.path());
+                    files++;
+                }
+            }
+        } else {
+            runFile(path);
+            files++;
+        }
+    }
+
+    std::mt19937 random(static_cast<std::mt19937::result_type>(seed));
+    for (unsigned long i = 0; i < runs; i++) {
+        ustring input = randomInput(random);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    std::cout << "Executed " << files << " files and " << runs << " random inputs (seed " << seed << ")\n";
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Awaitable commands for C++20 coroutines. The header is empty, if the
+ * compiler does not support coroutines.
+ *
+ * @file		CDCAwait.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCAwait_h_
+#define __CDCAwait_h_
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define CDC_AWAIT_SUPPORTED 1
+#endif
+#endif
+
+#ifdef CDC_AWAIT_SUPPORTED
+
+#include <CDCImpl.h>
+#include <CDCResult.h>
+#include "CDCTypes.h"
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+/**
+ * Awaitable command. Awaiting coroutine is suspended until the command is
+ * finished and it is resumed by the thread, which calls callbacks of
+ * *Async functions of CDCImpl - the reading thread, or the event loop.
+ * Resumed coroutine must not call synchronous functions of CDCImpl on
+ * that thread. The object is awaited once.
+ */
+template <typename T>
+class CDCAwaiter {
+public:
+	/** Function, which starts the command and calls its argument with the result. */
+	typedef std::function<void(std::function<void(const T&)>)> StartF;
+
+	explicit CDCAwaiter(StartF start)
+		:start(std::move(start)), finished(false) {}
+
+	bool await_ready(void) const noexcept { return false; }
+
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		// the callback can resume the coroutine and destroy this object
+		// before the start function returns
+		StartF startCommand = std::move(start);
+		startCommand([this, handle](const T& value) {
+			result.emplace(value);
+			// resumes only the coroutine, which has been suspended already
+			if (finished.exchange(true))
+				handle.resume();
+		});
+
+		// result given by the calling thread, e.g. an error, is taken
+		// without suspension, so that retry loops do not recurse
+		return !finished.exchange(true);
+	}
+
+	T await_resume(void) { return std::move(*result); }
+
+private:
+	StartF start;
+	std::optional<T> result;
+	std::atomic<bool> finished;
+};
+
+/**
+ * Result of awaited download.
+ */
+struct DownloadResult {
+	CDCResult<PMResponse> response;     /**< PM response or error */
+	ustring data;                       /**< downloaded data, valid if the response is OK */
+
+	DownloadResult(const CDCResult<PMResponse>& response, const ustring& data)
+		:response(response), data(data) {}
+};
+
+/**
+ * Returns awaitable variant of @c sendData.
+ * @param cdc communication object
+ * @param data data of DS command
+ * @return awaitable DS response or error
+ */
+inline CDCAwaiter<CDCResult<DSResponse>> awaitSendData(CDCImpl& cdc, const ustring& data)
+{
+	return CDCAwaiter<CDCResult<DSResponse>>([&cdc, data](std::function<void(const CDCResult<DSResponse>&)> resume) {
+		cdc.sendDataAsync(data, resume);
+	});
+}
+
+/**
+ * Returns awaitable variant of @c getStatus.
+ * @param cdc communication object
+ * @return awaitable SPI status or error
+ */
+inline CDCAwaiter<CDCResult<SPIStatus>> awaitGetStatus(CDCImpl& cdc)
+{
+	return CDCAwaiter<CDCResult<SPIStatus>>([&cdc](std::function<void(const CDCResult<SPIStatus>&)> resume) {
+		cdc.getStatusAsync(resume);
+	});
+}
+
+/**
+ * Returns awaitable variant of @c upload.
+ * @param cdc communication object
+ * @param target target of upload
+ * @param data data to upload
+ * @return awaitable PM response or error
+ */
+inline CDCAwaiter<CDCResult<PMResponse>> awaitUpload(CDCImpl& cdc, unsigned char target, const ustring& data)
+{
+	return CDCAwaiter<CDCResult<PMResponse>>([&cdc, target, data](std::function<void(const CDCResult<PMResponse>&)> resume) {
+		cdc.uploadAsync(target, data, resume);
+	});
+}
+
+/**
+ * Returns awaitable variant of @c download.
+ * @param cdc communication object
+ * @param target target of download
+ * @param inputData parameters of download
+ * @return awaitable PM response and downloaded data
+ */
+inline CDCAwaiter<DownloadResult> awaitDownload(CDCImpl& cdc, unsigned char target, const ustring& inputData)
+{
+	return CDCAwaiter<DownloadResult>([&cdc, target, inputData](std::function<void(const DownloadResult&)> resume) {
+		cdc.downloadAsync(target, inputData, [resume](const CDCResult<PMResponse>& response, const ustring& data) {
+			resume(DownloadResult(response, data));
+		});
+	});
+}
+
+#endif // CDC_AWAIT_SUPPORTED
+
+#endif // __CDCAwait_h_
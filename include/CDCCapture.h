@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Capture files of the raw byte stream exchanged with USB device.
+ *
+ * Capture file layout (all integers are little endian):
+ * - header:  "CDCCAP" magic (6 bytes), format version (1 byte), reserved (1 byte)
+ * - records: direction (1 byte, 'T' or 'R'), timestamp in microseconds
+ *            from the capture start (8 bytes), data length (4 bytes), data
+ *
+ * @file		CDCCapture.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCCapture_h_
+#define __CDCCapture_h_
+
+#include "CDCTypes.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+/** Direction of captured data. */
+enum CaptureDirection {
+	CAPTURE_TX = 'T',       /**< data sent from PC to USB device */
+	CAPTURE_RX = 'R'        /**< data received from USB device */
+};
+
+/** One record of capture file. */
+struct CaptureRecord {
+	CaptureDirection direction;         /**< direction of data */
+	unsigned long long timestamp;       /**< microseconds from capture start */
+	ustring data;                       /**< captured bytes */
+};
+
+/**
+ * Writes captured data into capture file. Thread safe - transmitted
+ * and received data are usually captured from different threads.
+ */
+class CDCCaptureWriter {
+private:
+	std::ofstream file;
+	std::mutex csFile;
+	std::chrono::steady_clock::time_point startTime;
+
+public:
+	/**
+	 * Creates capture file and writes its header.
+	 * @param fileName name of capture file
+	 * @throw CDCImplException if the file cannot be created
+	 */
+	CDCCaptureWriter(const char* fileName);
+
+	~CDCCaptureWriter();
+
+	/**
+	 * Appends record with specified data into capture file.
+	 * @param direction direction of captured data
+	 * @param data captured data
+	 * @param dlen length of captured data
+	 */
+	void write(CaptureDirection direction, const unsigned char* data, size_t dlen);
+};
+
+/**
+ * Reads records of capture file sequentially.
+ */
+class CDCCaptureReader {
+private:
+	std::ifstream file;
+
+public:
+	/**
+	 * Opens capture file and checks its header.
+	 * @param fileName name of capture file
+	 * @throw CDCImplException if the file cannot be opened or it is not a capture file
+	 */
+	CDCCaptureReader(const char* fileName);
+
+	~CDCCaptureReader();
+
+	/**
+	 * Reads next record.
+	 * @param record read record
+	 * @return @c true if the record was read
+	 * @return @c false at the end of capture file
+	 * @throw CDCImplException if the record is truncated
+	 */
+	bool next(CaptureRecord& record);
+};
+
+#endif // __CDCCapture_h_
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Discovery of COM-ports with connected USB devices.
+ *
+ * @file		CDCDiscovery.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCDiscovery_h_
+#define __CDCDiscovery_h_
+
+#include <CdcInterface.h>
+#include <CDCTypes.h>
+#include <string>
+#include <vector>
+
+/**
+ * Parameters of discovery.
+ */
+struct DiscoveryOptions {
+	unsigned int vendorId;          /**< USB vendor ID of ports, 0 for any USB device */
+	unsigned int productId;         /**< USB product ID of ports, 0 for any */
+	unsigned int probeTimeout;      /**< maximal time of waiting for a probe response [ms] */
+	unsigned int settleDelay;       /**< delay before flushing probed port [ms] */
+
+	DiscoveryOptions()
+		:vendorId(0x1DE6), productId(0), probeTimeout(500), settleDelay(50) {}
+};
+
+/**
+ * Port with responding USB device.
+ */
+struct DiscoveredDevice {
+	std::string portName;           /**< name of the port */
+	USBDeviceInfo deviceInfo;       /**< identification of the device */
+};
+
+/**
+ * Probes specified ports in parallel - each port is opened and the device
+ * is tested and asked for identification with short timeouts. Ports,
+ * which cannot be opened or which do not respond, are skipped.
+ * @param portNames names of ports to probe
+ * @param options parameters of probing
+ * @return responding devices in order of specified ports
+ */
+std::vector<DiscoveredDevice> probeDevicePorts(const std::vector<std::string>& portNames,
+	const DiscoveryOptions& options = DiscoveryOptions());
+
+#ifndef WIN32
+
+/**
+ * Finds ports of USB devices with specified vendor and product ID in
+ * /sys/class/tty. No port is opened. Available on Linux only.
+ * @param options parameters of discovery
+ * @return names of found ports, sorted
+ */
+std::vector<std::string> findDevicePorts(const DiscoveryOptions& options = DiscoveryOptions());
+
+/**
+ * Finds ports of USB devices and probes them. Available on Linux only.
+ * @param options parameters of discovery
+ * @return responding devices
+ */
+std::vector<DiscoveredDevice> discoverDevices(const DiscoveryOptions& options = DiscoveryOptions());
+
+#endif
+
+#endif // __CDCDiscovery_h_
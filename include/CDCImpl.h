@@ -33,28 +33,208 @@
 #include <CDCImplException.h>
 #include <CDCSendException.h>
 #include <CDCReceiveException.h>
+#include <CDCTransport.h>
+#include <CDCResult.h>
 #include "CDCTypes.h"
 
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 /**
  * Forward declaration of CDCImpl implementation class.
  */
 class CDCImplPrivate;
 
+/**
+ * Listener of SPI status changes. The first parameter is the previous
+ * status, the second one is the new status.
+ */
+typedef std::function<void(const SPIStatus&, const SPIStatus&)> SPIStatusListenerF;
+
+/**
+ * Scheduling policy of thread.
+ */
+enum class ThreadPolicy {
+	DEFAULT,    /**< policy is not changed */
+	FIFO,       /**< real-time first in, first out policy (SCHED_FIFO) */
+	RR          /**< real-time round robin policy (SCHED_RR) */
+};
+
+/**
+ * Settings of thread, applied when the thread is started. Real-time
+ * policies usually require privileges (CAP_SYS_NICE). Non-default
+ * settings are supported on Linux.
+ */
+struct ThreadOptions {
+	ThreadPolicy policy;            /**< scheduling policy */
+	int priority;                   /**< priority of real-time policy, 1 - 99 on Linux */
+	std::vector<unsigned int> cpus; /**< CPUs the thread may run on, empty for all */
+	std::string name;               /**< name of the thread, at most 15 characters are used, empty for none */
+
+	ThreadOptions()
+		:policy(ThreadPolicy::DEFAULT), priority(0) {}
+};
+
+/**
+ * Options of communication object.
+ */
+struct CDCImplOptions {
+	unsigned int responseTimeout;   /**< maximal time of waiting for a response [ms] */
+	unsigned int settleDelay;       /**< delay before flushing opened port [ms], used on Linux */
+	bool eventLoop;                 /**< no reading thread is started, see @c onReadable, supported on Linux */
+	ThreadOptions readerThread;     /**< settings of reading thread, which also calls listeners */
+	ThreadOptions monitorThread;    /**< settings of thread started by @c startStatusMonitor */
+	bool realtime;                  /**< buffers of frames are preallocated, see @c framePoolSize */
+	unsigned int framePoolSize;     /**< count of preallocated buffers of frames in realtime mode */
+	std::pmr::memory_resource* memoryResource;  /**< memory of the object and its buffers, @c NULL for the default resource */
+
+	CDCImplOptions()
+		:responseTimeout(5000), settleDelay(2000), eventLoop(false), realtime(false), framePoolSize(16),
+		memoryResource(NULL) {}
+};
+
+/**
+ * Callback of DS command sent by @c sendDataAsync. It gets DS response
+ * or error, e.g. @c RESPONSE_TIMEOUT.
+ */
+typedef std::function<void(const CDCResult<DSResponse>&)> DataSendCallbackF;
+
+/**
+ * Callback of S command sent by @c getStatusAsync.
+ */
+typedef std::function<void(const CDCResult<SPIStatus>&)> StatusCallbackF;
+
+/**
+ * Callback of upload sent by @c uploadAsync.
+ */
+typedef std::function<void(const CDCResult<PMResponse>&)> UploadCallbackF;
+
+/**
+ * Callback of download sent by @c downloadAsync. It gets PM response
+ * and downloaded data, which are valid, if the response is @c OK.
+ */
+typedef std::function<void(const CDCResult<PMResponse>&, const std::basic_string<unsigned char>&)> DownloadCallbackF;
+
+/**
+ * Filter of asynchronous messages on fields of DPA header. Each field
+ * either has to match, or it is @c ANY. Command is compared without
+ * response flag, so the filter matches both confirmation and response.
+ */
+struct AsyncMsgFilter {
+	static const int ANY = -1;
+	int nodeAddress;    /**< NADR */
+	int peripheral;     /**< PNUM */
+	int command;        /**< PCMD without response flag */
+
+	AsyncMsgFilter(int nodeAddress = ANY, int peripheral = ANY, int command = ANY)
+		:nodeAddress(nodeAddress), peripheral(peripheral), command(command) {}
+};
+
+/**
+ * Listener of connection changes after loss of the device. The parameter
+ * is @c true if the device was reconnected, @c false if it was lost.
+ */
+typedef std::function<void(bool)> ConnectionListenerF;
+
+/**
+ * Processing of commands, which are pending when the device is lost.
+ */
+enum class PendingCommandPolicy {
+	FAIL,       /**< commands fail with @c DEVICE_DISCONNECTED error */
+	REPLAY      /**< commands wait for reconnection and are sent again */
+};
+
+/**
+ * Reconnecting after loss of the device, e.g. after unplugging of USB
+ * dongle. If enabled, failed reading from COM-port does not stop the
+ * reception. The port is closed and the reading thread waits for the
+ * device node to reappear, reopens it and continues reading. Registered
+ * listeners are kept. Supported on Linux for COM-ports specified by name.
+ */
+struct ReconnectOptions {
+	bool enabled;                           /**< reconnecting is enabled */
+	unsigned int timeout;                   /**< maximal time of waiting for the device [ms], @c 0 for no limit */
+	unsigned int settleDelay;               /**< delay before flushing reopened port [ms] */
+	PendingCommandPolicy pendingCommands;   /**< processing of pending commands */
+
+	ReconnectOptions()
+		:enabled(false), timeout(0), settleDelay(100), pendingCommands(PendingCommandPolicy::FAIL) {}
+};
+
+/**
+ * Pacing of DS commands. If enabled, DS command refused by the module
+ * with BUSY response is held and sent again, as soon as SPI status
+ * reports the module ready for communication. While the module is not
+ * ready, SPI status is queried with exponentially growing delays.
+ * BUSY is returned only if the module does not accept the command within
+ * the timeout.
+ */
+struct PacingOptions {
+	bool enabled;                   /**< pacing of DS commands is enabled */
+	unsigned int initialBackoff;    /**< first delay between status queries [us] */
+	unsigned int maxBackoff;        /**< maximal delay between status queries [us] */
+	unsigned int timeout;           /**< maximal time of holding DS command [ms] */
+
+	PacingOptions()
+		:enabled(false), initialBackoff(1000), maxBackoff(100000), timeout(5000) {}
+};
+
+/**
+ * Busy polling of the reading thread. If enabled, the reading thread does
+ * not block after each send or receive, but it polls the port without
+ * waiting for specified time. Response received during this time does
+ * not wait for waking up of the thread by the scheduler, at the cost of
+ * the CPU time spent by polling. Supported on Linux, it has no effect in
+ * event loop mode.
+ */
+struct BusyPollOptions {
+	bool enabled;           /**< busy polling is enabled */
+	unsigned int spinTime;  /**< time of polling after each send or receive [us] */
+
+	BusyPollOptions()
+		:enabled(false), spinTime(200) {}
+};
+
+/**
+ * Metrics of communication, counted since creation of the object.
+ * Average response latency is @c responseLatency / @c responses.
+ */
+struct CDCMetrics {
+	unsigned long long receivedMessages;    /**< processed messages including asynchronous ones */
+	unsigned long long blockingReceptions;  /**< readings of data after blocking wait */
+	unsigned long long spinReceptions;      /**< readings of data found by busy polling */
+	unsigned long long spinTime;            /**< time spent by busy polling [us] */
+	unsigned long long responses;           /**< responses of synchronous commands */
+	unsigned long long responseLatency;     /**< sum of times from sending to response of synchronous commands [us] */
+	unsigned long long poolMisses;          /**< buffers of frames allocated in realtime mode, because the pool was exhausted */
+	unsigned long long badFrames;           /**< received frames with bad format */
+	unsigned long long discardedBytes;      /**< bytes discarded by resynchronization after bad frames */
+
+	CDCMetrics()
+		:receivedMessages(0), blockingReceptions(0), spinReceptions(0), spinTime(0),
+		responses(0), responseLatency(0), poolMisses(0), badFrames(0), discardedBytes(0) {}
+};
+
 /**
  * Implements public interface of CDCInterface abstract class for communication
  * support between PC and GW-USB-04 device.
  *
  * Properties:
- * - Dedicated thread for reading from COM-port( COM1 is default ).
+ * - Dedicated thread for reading from COM-port( COM1 is default ), or
+ *   reading driven by event loop of the application.
  * - Exception mechanism for dealing with some type of errors.
  * - Simple validation mechanism for incoming message data.
- * - Inner timeout settings(usually 5000 ms) for waiting for operations,
- *     user-defined timeout settings are not currently supported.
+ * - Timeout of waiting for responses (5000 ms by default) and delay before
+ *   flushing opened port are set by @c CDCImplOptions::responseTimeout and
+ *   @c CDCImplOptions::settleDelay passed to the constructor.
  * - If some serious error occurs during reading from COM-port, the reading thread is
- *   automatically stopped. Stopped thread is currently not possible to start
- *   again - for continuous working you must destruct the object and
+ *   automatically stopped, unless reconnecting is enabled by @c setReconnect
+ *   (Linux, port opened by the object). In that case the reading thread
+ *   reopens the port as soon as the device is available again, within
+ *   @c ReconnectOptions::timeout, and pending commands are failed or
+ *   replayed according to @c ReconnectOptions::pendingCommands. Without
+ *   reconnecting, for continuous working you must destruct the object and
  *   construct the another one. Activity of reading thread can be tested via
  *   @c isReceptionStopped function. If some method from public interface is
  *   called after the reading thread was stopped, exception will be thrown.
@@ -84,6 +264,31 @@ public:
 		 */
 		CDCImpl(const char* commPort);
 
+		/**
+		 * Creates instance with specified COM-port and options.
+		 * @param commPort COM-port to communicate with
+		 * @param options options of communication
+		 * @throw CDCImplException if some error occurs during initialization
+		 */
+		CDCImpl(const char* commPort, const CDCImplOptions& options);
+
+		/**
+		 * Creates instance communicating over specified transport, e.g.
+		 * the one of CDCSimulator. Supported on Linux only.
+		 * @param transport transport to USB device, the instance takes its ownership
+		 * @throw CDCImplException if some error occurs during initialization
+		 */
+		CDCImpl(CDCTransport* transport);
+
+		/**
+		 * Creates instance communicating over specified transport with
+		 * specified options. Supported on Linux only.
+		 * @param transport transport to USB device, the instance takes its ownership
+		 * @param options options of communication
+		 * @throw CDCImplException if some error occurs during initialization
+		 */
+		CDCImpl(CDCTransport* transport, const CDCImplOptions& options);
+
 		/**
 		 * Destroys communication object and frees all needed resources.
 		 */
@@ -119,6 +324,28 @@ public:
 		 */
 		ModuleInfo* getTRModuleInfo(void);
 
+		/**
+		 * Returns USB device identification. The identification is received
+		 * from the device by the first call only, further calls return the
+		 * cached value until @c resetUSBDevice is called.
+		 * @return USB device identification
+		 * @throw CDCSendException if some error occurs during sending command
+		 * @throw CDCReceiveException if some error occurs during response reception
+		 */
+		USBDeviceInfo getCachedUSBDeviceInfo(void);
+
+		/**
+		 * Returns TR module identification. The identification is received
+		 * from the device by the first call only, further calls return the
+		 * cached value until @c resetUSBDevice, @c resetTRModule or
+		 * @c terminateProgrammingMode is called.
+		 * @return TR module identification
+		 * @throw CDCSendException if some error occurs during sending command
+		 * @throw CDCReceiveException if some error occurs during response
+		 *        reception or if the identification data are corrupted
+		 */
+		ModuleInfo getCachedTRModuleInfo(void);
+
 		/**
 		 * @throw CDCSendException if some error occurs during sending command
 		 * @throw CDCReceiveException if some error occurs during response reception
@@ -174,10 +401,248 @@ public:
                                     const std::basic_string<unsigned char>& inputData,
                                     std::basic_string<unsigned char>& outputData);
 
+		/**
+		 * Non-throwing variant of @c test. Errors like timeouts are reported
+		 * by the returned result, their messages are formatted only on request.
+		 * @return result of the test
+		 */
+		CDCResult<bool> tryTest(void) noexcept;
+
+		/**
+		 * Non-throwing variant of @c getStatus.
+		 * @return SPI status or error
+		 */
+		CDCResult<SPIStatus> tryGetStatus(void) noexcept;
+
+		/**
+		 * Non-throwing variant of @c sendData, suitable for retry loops.
+		 * @return DS response or error
+		 */
+		CDCResult<DSResponse> trySendData(const unsigned char* data, unsigned int dlen) noexcept;
+		CDCResult<DSResponse> trySendData(const std::basic_string<unsigned char>& data) noexcept;
+
+		/**
+		 * Sends DS commands with specified data as one batch. All commands
+		 * are written to the port at once, their responses are collected by
+		 * the reading thread and the caller is woken up after the last one.
+		 * Frames longer than 255 bytes are not sent and get @c DATA_TOO_LARGE.
+		 * The commands are not paced and they are not replayed after
+		 * reconnection. Errors are reported by the results, not by exceptions.
+		 * @param frames data of DS commands
+		 * @return DS response or error of each frame, in the order of the frames
+		 */
+		std::vector<CDCResult<DSResponse>> sendDataBatch(
+			const std::vector<std::basic_string<unsigned char>>& frames);
+
+		/**
+		 * Non-throwing variant of @c upload.
+		 * @return PM response or error
+		 */
+		CDCResult<PMResponse> tryUpload(unsigned char target, const unsigned char* data,
+                                    unsigned int dlen) noexcept;
+
+		/**
+		 * Sends DS command without waiting for its response. Commands of all
+		 * *Async functions are queued and sent one by one, each after the
+		 * response to the previous one. The callback is called by the reading
+		 * thread (or by the thread calling @c onReadable or @c onTimer in
+		 * event loop mode), or by the calling thread, if the command cannot
+		 * be sent. The callback must not call synchronous functions. The
+		 * commands are not paced. Supported on Linux.
+		 * @param data data of DS command
+		 * @param dlen length of the data
+		 * @param callback callback of the command
+		 */
+		void sendDataAsync(const unsigned char* data, unsigned int dlen, DataSendCallbackF callback);
+		void sendDataAsync(const std::basic_string<unsigned char>& data, DataSendCallbackF callback);
+
+		/**
+		 * Asynchronous variant of @c getStatus, see @c sendDataAsync.
+		 * @param callback callback of the command
+		 */
+		void getStatusAsync(StatusCallbackF callback);
+
+		/**
+		 * Asynchronous variant of @c upload, see @c sendDataAsync. Invalid
+		 * target is reported by @c INVALID_ARGUMENT error.
+		 * @param target target of upload
+		 * @param data data to upload
+		 * @param callback callback of the command
+		 */
+		void uploadAsync(unsigned char target, const std::basic_string<unsigned char>& data,
+			UploadCallbackF callback);
+
+		/**
+		 * Asynchronous variant of @c download, see @c sendDataAsync. Invalid
+		 * target is reported by @c INVALID_ARGUMENT error.
+		 * @param target target of download
+		 * @param inputData parameters of download
+		 * @param callback callback of the command
+		 */
+		void downloadAsync(unsigned char target, const std::basic_string<unsigned char>& inputData,
+			DownloadCallbackF callback);
+
+		/**
+		 * Returns file descriptor, which the event loop polls for readability,
+		 * and for writability if @c isWritePending returns @c true. Supported
+		 * on Linux.
+		 * @return file descriptor of COM-port
+		 * @throw CDCImplException on other platforms
+		 */
+		int getPollHandle(void);
+
+		/**
+		 * Indicates, whether queued DS command was not written completely.
+		 * @return @c true if @c onWritable should be called after the port
+		 *         becomes writable
+		 */
+		bool isWritePending(void);
+
+		/**
+		 * Returns time, after which @c onTimer should be called. The value
+		 * changes by sending and finishing of commands by @c sendDataAsync,
+		 * so the event loop gets it again after each entry point call.
+		 * @return time to the nearest timeout [ms], @c -1 if there is none
+		 */
+		int getTimerTimeout(void);
+
+		/**
+		 * In event loop mode (@c CDCImplOptions::eventLoop), reads all data
+		 * available on the port without blocking and processes received
+		 * messages - the caller gets asynchronous messages and callbacks of
+		 * @c sendDataAsync. Entry points must not be called concurrently.
+		 * Synchronous commands, e.g. @c sendData, wait for their responses
+		 * received by this function, so they must be called by other threads.
+		 * @return status of reading, failed reading stops the reception
+		 */
+		CDCStatus onReadable(void);
+
+		/**
+		 * In event loop mode, writes rest of queued DS command without blocking.
+		 * @return status of writing, failed command is finished by its callback
+		 */
+		CDCStatus onWritable(void);
+
+		/**
+		 * In event loop mode, finishes queued DS command, whose response timeouted.
+		 */
+		void onTimer(void);
+
+		/**
+		 * Sets pacing of DS commands sent by @c sendData and @c trySendData.
+		 * Pacing is disabled by default.
+		 * @param options pacing options
+		 */
+		void setPacing(const PacingOptions& options);
+
+		/**
+		 * Sets busy polling of the reading thread. Disabled by default.
+		 * @param options busy polling options
+		 */
+		void setBusyPoll(const BusyPollOptions& options);
+
+		/**
+		 * Returns metrics of communication, e.g. to compare latency and CPU
+		 * cost with and without busy polling.
+		 * @return current metrics
+		 */
+		CDCMetrics getMetrics(void);
+
+		/**
+		 * Starts monitor thread, which refreshes cached SPI status by
+		 * S command. Already running monitor is stopped first.
+		 * @param interval interval of refreshing in milliseconds, @c 0 disables
+		 *        periodic refreshing
+		 * @param refreshOnTraffic if @c true, the status is refreshed also
+		 *        after each DS response and DR message
+		 * @throw CDCImplException if @c monitorThread options cannot be applied
+		 */
+		void startStatusMonitor(unsigned int interval, bool refreshOnTraffic = true);
+
+		/**
+		 * Stops monitor thread. Must not be called from status listener.
+		 */
+		void stopStatusMonitor(void);
+
+		/**
+		 * Returns the last received SPI status without any communication
+		 * with USB device. The cache is updated by the monitor thread and by
+		 * each S command, e.g. @c getStatus. Lock-free.
+		 * @return cached SPI status, or @c STATUS_UNKNOWN error if no status
+		 *         has been received yet
+		 */
+		CDCResult<SPIStatus> getCachedStatus(void) noexcept;
+
+		/**
+		 * Registers listener of SPI status changes. The listener is called
+		 * by the thread, which has received the changed status.
+		 * @param statusListener listener of status changes
+		 */
+		void registerStatusListener(SPIStatusListenerF statusListener);
+
+		void unregisterStatusListener(void);
+
+		/**
+		 * Sets reconnecting after loss of the device. Disabled by default.
+		 * Note, that @c REPLAY policy sends again also commands, which could
+		 * have been already executed by the device before its loss.
+		 * @param options reconnecting options
+		 */
+		void setReconnect(const ReconnectOptions& options);
+
+		/**
+		 * Registers listener of connection changes. The listener is called
+		 * by the reading thread.
+		 * @param connectionListener listener of connection changes
+		 */
+		void registerConnectionListener(ConnectionListenerF connectionListener);
+
+		void unregisterConnectionListener(void);
+
+		/**
+		 * Registers listener of asynchronous messages. Unlike listeners added
+		 * by @c addAsyncMsgListener, only one such listener is registered,
+		 * the previous one is replaced.
+		 * @param asyncListener listener of asynchronous messages
+		 */
 		void registerAsyncMsgListener(AsyncMsgListenerF asyncListener);
 
 		void unregisterAsyncMsgListener(void);
 
+		/**
+		 * Adds listener of asynchronous messages matching specified filter.
+		 * Messages shorter than DPA header are passed only to listeners
+		 * without filter. Listeners are called by the reading thread in
+		 * order of their adding and they get the same data, which must not
+		 * be modified.
+		 * @param asyncListener listener of asynchronous messages
+		 * @param filter filter of messages
+		 * @return identifier of the listener for @c removeAsyncMsgListener
+		 */
+		unsigned int addAsyncMsgListener(AsyncMsgListenerF asyncListener,
+			const AsyncMsgFilter& filter = AsyncMsgFilter());
+
+		/**
+		 * Removes listener of asynchronous messages. After return, the
+		 * listener is not called anymore, unless it is removed by itself.
+		 * @param listenerId identifier returned by @c addAsyncMsgListener
+		 */
+		void removeAsyncMsgListener(unsigned int listenerId);
+
+		/**
+		 * Starts capturing of all data exchanged with USB device into
+		 * specified capture file (format is described in CDCCapture.h).
+		 * Already running capture is stopped first.
+		 * @param fileName name of capture file
+		 * @throw CDCImplException if the capture file cannot be created
+		 */
+		void startCapture(const char* fileName);
+
+		/**
+		 * Stops capturing of exchanged data.
+		 */
+		void stopCapture(void);
+
 		/**
 		 * Indicates, whether reception of messages from associated COM-port
 		 * is stopped.
@@ -37,16 +37,16 @@
  */
 class CDCImplException : public std::exception {
 private:
-	/* Identity string of this exception class. */
-	std::string identity;
-
-	/* Complete desription of exception. */
+	/* Complete desription of exception, created on first request. */
 	std::string descr;
 
 	/* Creates desription. */
 	void createDescription();
 
 protected:
+	/* Identity string of this exception class, set by each subclass. */
+	const char* identity;
+
 	/* Cause of exception. */
 	std::string cause;
 
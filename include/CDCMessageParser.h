@@ -48,6 +48,29 @@ struct ParseResult {
 	unsigned int lastPosition;		/**< last parsed position */
 };
 
+/**
+ * Response expected by the parser. Frames of PM responses and TR module
+ * info carry no length and their data can contain 0x0D, so the parser
+ * delimits them by the response of the outstanding command. Without the
+ * expectation, they are delimited by the size of parsed data, which fails,
+ * if other message follows in the data.
+ */
+struct ParseContext {
+	MessageType expectedType;       /**< MSG_UPLOAD_DOWNLOAD for upload, MSG_DOWNLOAD_DATA, MSG_TR_INFO, or MSG_ERROR if nothing is expected */
+	unsigned int expectedLength;    /**< length of expected frame including header and 0x0D, @c 0 if unknown */
+
+	ParseContext(MessageType expectedType = MSG_ERROR, unsigned int expectedLength = 0)
+		:expectedType(expectedType), expectedLength(expectedLength) {}
+};
+
+/**
+ * Implementation of parsing.
+ */
+enum class ParserMode {
+	FSM,                    /**< reference finite automaton only */
+	FAST                    /**< fast paths of frequent messages, finite automaton otherwise */
+};
+
 /**
  * Forward declaration of CDCMessageParser implementation class.
  */
@@ -68,6 +91,14 @@ public:
 	 */
 	CDCMessageParser();
 
+	/**
+	 * Constructs message parser with specified implementation of parsing.
+	 * Both implementations give the same results, @c FSM mode serves as
+	 * the reference in differential testing.
+	 * @param mode implementation of parsing
+	 */
+	explicit CDCMessageParser(ParserMode mode);
+
 	/**
 	 *  Frees up used resources.
 	 */
@@ -75,57 +106,71 @@ public:
 
 	/**
 	 * Parses specified data and returns result.
+	 * @param context response expected by the caller
 	 * @return result of parsing of specified data
 	 */
-	ParseResult parseData(ustring& data);
+	ParseResult parseData(ustring_view data, const ParseContext& context = ParseContext());
 
 	/**
 	 * Returns USB device info from specified data.
 	 * @return USB device info from specified data.
 	 */
-	DeviceInfo* getParsedDeviceInfo(ustring& data);
+	DeviceInfo* getParsedDeviceInfo(ustring_view data);
+
+	/**
+	 * Parses USB device info from specified data into inline storage.
+	 * @param devInfo parsed USB device info
+	 */
+	void getParsedDeviceInfo(ustring_view data, USBDeviceInfo& devInfo);
 
 	/**
 	 * Returns TR module info from specified data.
 	 * @return TR module info from specified data.
 	 */
-	ModuleInfo* getParsedModuleInfo(ustring& data);
+	ModuleInfo* getParsedModuleInfo(ustring_view data);
+
+	/**
+	 * Parses TR module info from specified data.
+	 * @param modInfo parsed TR module info
+	 * @return @c false if identification data have wrong size
+	 */
+	bool getParsedModuleInfo(ustring_view data, ModuleInfo& modInfo);
 
 	/**
 	 * Returns SPI status from specified data.
 	 * @return SPI status from specified data.
 	 */
-	SPIStatus getParsedSPIStatus(ustring& data);
+	SPIStatus getParsedSPIStatus(ustring_view data);
 
 	/**
 	 * Returns data send response from specified data.
 	 * @return data send response from specified data.
 	 */
-	DSResponse getParsedDSResponse(ustring& data);
+	DSResponse getParsedDSResponse(ustring_view data);
 
 	/**
 	 * Returns data part of last parsed DR message.
 	 * @returns data part of last parsed DR message.
 	 */
-    ustring getParsedDRData(ustring& data);
+    ustring getParsedDRData(ustring_view data);
 
 	/**
 	 * Returns enable programming mode response from specified data.
 	 * @return data send response from specified data.
 	 */
-	PTEResponse getParsedPEResponse(ustring& data);
+	PTEResponse getParsedPEResponse(ustring_view data);
 
 	/**
 	 * Returns terminate programming mode response from specified data.
 	 * @return data send response from specified data.
 	 */
-	PTEResponse getParsedPTResponse(ustring& data);
+	PTEResponse getParsedPTResponse(ustring_view data);
 
 	/**
 	 * Returns upload TR module memory response from specified data.
 	 * @return data send response from specified data.
 	 */
-	PMResponse getParsedPMResponse(ustring& data);
+	PMResponse getParsedPMResponse(ustring_view data);
 
 	/**
 	 * Returns data part of last parsed PM message.
@@ -134,7 +179,7 @@ public:
          * returned MSG_UPLOAD_DOWNLOAD.
 	 * @returns data part of last parsed PM message.
 	 */
-	ustring getParsedPMData(ustring& data);
+	ustring getParsedPMData(ustring_view data);
 };
 
 #endif // __CDCMessageParser_h_
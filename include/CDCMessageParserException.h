@@ -35,10 +35,6 @@
  * Exception, which occurs during running of CDC message parser.
  */
 class CDCMessageParserException : public CDCImplException {
-private:
-	/* Identity string of this exception class. */
-	std::string identity;
-
 public:
 	/**
 	 * Constructs exception object.
@@ -35,10 +35,6 @@
  * Exception, which occurs during receiving messages from COM-port.
  */
 class CDCReceiveException : public CDCImplException {
-private:
-	/* Identity string of this exception class. */
-	std::string identity;
-
 public:
 	/**
 	 * Constructs exception object.
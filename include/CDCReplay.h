@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Replay of captured traffic in place of real USB device. Available
+ * on Linux only.
+ *
+ * @file		CDCReplay.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCReplay_h_
+#define __CDCReplay_h_
+
+#include <CDCTransport.h>
+#include <string>
+
+/** Speed of replay. */
+enum class ReplaySpeed {
+	RECORDED,       /**< received data are delayed as they were recorded */
+	MAXIMAL         /**< received data are written as fast as possible */
+};
+
+/** Statistics of replay. */
+struct ReplayStats {
+	unsigned long long rxRecords;       /**< replayed received records */
+	unsigned long long rxBytes;         /**< replayed received bytes */
+	unsigned long long txRecords;       /**< verified transmitted records */
+	unsigned long long txBytes;         /**< verified transmitted bytes */
+	unsigned long long txMismatches;    /**< transmitted records differing from capture */
+	double elapsed;                     /**< duration of replay in seconds */
+};
+
+/**
+ * Forward declaration of CDCReplay implementation class.
+ */
+class CDCReplayPrivate;
+
+/**
+ * Plays role of USB device according to a capture file (see CDCCapture.h).
+ * Replay creates pseudo-terminal, whose name (or transport) is passed
+ * to CDCImpl instead of the name of real COM-port. After CDCImpl is
+ * constructed, @c start begins to write captured received data into the
+ * pseudo-terminal, so they pass through the whole reading pipeline of CDCImpl. Each captured
+ * transmitted record must be sent by CDCImpl before the replay continues
+ * and it is compared to the sent data.
+ */
+class CDCReplay {
+private:
+	// Pointer to implementation object(d-pointer).
+	CDCReplayPrivate* implObj;
+
+public:
+	/**
+	 * Loads capture file and creates pseudo-terminal.
+	 * @param captureFile capture file to replay
+	 * @param speed speed of replay
+	 * @throw CDCImplException if some error occurs during initialization
+	 */
+	CDCReplay(const char* captureFile, ReplaySpeed speed = ReplaySpeed::RECORDED);
+
+	/**
+	 * Stops replay and frees all needed resources.
+	 */
+	~CDCReplay();
+
+	/**
+	 * Returns name of port to pass to CDCImpl constructor.
+	 * @return name of port
+	 */
+	const char* getPortName(void);
+
+	/**
+	 * Creates transport connected to the replay, which can be passed
+	 * to CDCImpl constructor instead of port name. Unlike the port name,
+	 * the transport skips settings of serial port and their delay.
+	 * @return transport connected to the replay
+	 * @throw CDCImplException if the transport cannot be created
+	 */
+	CDCTransport* createTransport(void);
+
+	/**
+	 * Starts replay in dedicated thread.
+	 */
+	void start(void);
+
+	/**
+	 * Waits until the replay ends.
+	 * @param timeout maximal time to wait in milliseconds, @c 0 means infinity
+	 * @return @c true if the replay has ended
+	 * @return @c false if waiting timeouted
+	 */
+	bool waitForEnd(unsigned int timeout = 0);
+
+	/**
+	 * Returns statistics of the replay.
+	 * @return statistics of the replay
+	 */
+	ReplayStats getStats(void);
+
+	/**
+	 * Returns description of last error, which has occurred during replay,
+	 * i.e. first transmitted data mismatch or timeout of waiting for them.
+	 * @return last replay error, empty string if none has occurred
+	 */
+	std::string getLastError(void);
+};
+
+#endif // __CDCReplay_h_
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Results of non-throwing operations of CDCImpl class.
+ *
+ * @file		CDCResult.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCResult_h_
+#define __CDCResult_h_
+
+#include <string>
+
+/**
+ * Error codes of operations.
+ */
+enum class CDCErrorCode {
+	OK,                     /**< no error */
+	RECEPTION_STOPPED,      /**< reading thread is stopped */
+	INVALID_ARGUMENT,       /**< invalid argument, e.g. target of upload */
+	DATA_TOO_LARGE,         /**< data of command are too large */
+	SEND_TIMEOUT,           /**< sending command timeouted */
+	SEND_FAILED,            /**< sending command failed with system error */
+	RESPONSE_TIMEOUT,       /**< waiting for response timeouted */
+	RECEIVE_FAILED,         /**< waiting for response failed with system error */
+	BAD_RESPONSE,           /**< response has bad type */
+	STATUS_UNKNOWN,         /**< no SPI status has been received yet */
+	DEVICE_DISCONNECTED,    /**< connection to the device was lost */
+	INTERNAL_ERROR          /**< unexpected internal error */
+};
+
+/**
+ * Returns static description of specified error code.
+ * @param code error code
+ * @return description of the error code
+ */
+const char* getErrorCodeDescr(CDCErrorCode code) noexcept;
+
+/**
+ * Status of finished operation - error code and system error
+ * (@c errno on Linux, @c GetLastError on Windows), if any.
+ * The text message is formatted only if requested.
+ */
+class CDCStatus {
+private:
+	CDCErrorCode code;
+	int sysError;
+
+public:
+	/**
+	 * Creates status with specified error.
+	 * @param code error code
+	 * @param sysError system error code, @c 0 if none
+	 */
+	CDCStatus(CDCErrorCode code = CDCErrorCode::OK, int sysError = 0) noexcept
+		:code(code), sysError(sysError) {}
+
+	/**
+	 * Indicates, whether the operation succeeded.
+	 * @return @c true if the operation succeeded
+	 */
+	bool ok(void) const noexcept { return code == CDCErrorCode::OK; }
+
+	explicit operator bool() const noexcept { return ok(); }
+
+	/**
+	 * Returns error code of the operation.
+	 * @return error code
+	 */
+	CDCErrorCode error(void) const noexcept { return code; }
+
+	/**
+	 * Returns system error code of the operation.
+	 * @return system error code, @c 0 if none
+	 */
+	int systemError(void) const noexcept { return sysError; }
+
+	/**
+	 * Formats message describing the status.
+	 * @return message describing the status
+	 */
+	std::string message(void) const;
+};
+
+/**
+ * Result of operation - status and, if the operation succeeded, value.
+ */
+template <typename T>
+class CDCResult : public CDCStatus {
+private:
+	T val;
+
+public:
+	/**
+	 * Creates successful result.
+	 * @param value value of the result
+	 */
+	CDCResult(const T& value) noexcept
+		:val(value) {}
+
+	/**
+	 * Creates failed result.
+	 * @param status status of the failed operation
+	 */
+	CDCResult(const CDCStatus& status) noexcept
+		:CDCStatus(status), val() {}
+
+	/**
+	 * Returns value of the result, valid only if @c ok returns @c true.
+	 * @return value of the result
+	 */
+	const T& value(void) const noexcept { return val; }
+};
+
+#endif // __CDCResult_h_
@@ -35,10 +35,6 @@
  * Exception, which occurs during sending command to COM-port.
  */
 class CDCSendException : public CDCImplException {
-private:
-	/* Identity string of this exception class. */
-	std::string identity;
-
 public:
 	/**
 	 * Constructs exception object.
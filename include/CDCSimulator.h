@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Simulator of USB device with CDC IQRF firmware. Available on Linux only.
+ *
+ * @file		CDCSimulator.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCSimulator_h_
+#define __CDCSimulator_h_
+
+#include <CdcInterface.h>
+#include <CDCTransport.h>
+
+/**
+ * Behaviour of simulated USB device.
+ */
+struct SimulatorOptions {
+	unsigned int responseLatency;   /**< delay of responses in microseconds */
+	unsigned int asyncRate;         /**< generated DR messages per second, 0 for none */
+	unsigned int asyncLength;       /**< data length of generated DR messages */
+	bool dpaResponses;              /**< answer accepted DS data by DPA response in DR message */
+	DSResponse dsResponse;          /**< response to DS messages */
+	SPIModes spiMode;               /**< reported SPI status */
+	unsigned int corruptInterval;   /**< each n-th generated DR message has corrupted header, length or end, 0 for none */
+
+	SimulatorOptions()
+		:responseLatency(0), asyncRate(0), asyncLength(10), dpaResponses(false),
+		dsResponse(OK), spiMode(READY_COMM), corruptInterval(0) {}
+};
+
+/**
+ * Statistics of simulated USB device.
+ */
+struct SimulatorStats {
+	unsigned long long commands;        /**< processed commands */
+	unsigned long long asyncMessages;   /**< sent DR messages */
+	unsigned long long droppedMessages; /**< DR messages dropped, because nobody reads them */
+	unsigned long long corruptedMessages; /**< DR messages sent with corrupted byte */
+	unsigned long long rxBytes;         /**< bytes received from CDCImpl */
+	unsigned long long txBytes;         /**< bytes sent to CDCImpl */
+};
+
+/**
+ * Forward declaration of CDCSimulator implementation class.
+ */
+class CDCSimulatorPrivate;
+
+/**
+ * Emulates CDC protocol of IQRF USB device on a pseudo-terminal, so
+ * CDCImpl can be tested or benchmarked without the device. Supported
+ * commands are test, R, RT, I, IT, B, S, DS, U, PE, PT and PM. The device
+ * runs in its own thread from construction to destruction.
+ */
+class CDCSimulator {
+private:
+	// Pointer to implementation object(d-pointer).
+	CDCSimulatorPrivate* implObj;
+
+public:
+	/**
+	 * Creates pseudo-terminal and starts simulated device.
+	 * @param options behaviour of simulated device
+	 * @throw CDCImplException if some error occurs during initialization
+	 */
+	CDCSimulator(const SimulatorOptions& options = SimulatorOptions());
+
+	/**
+	 * Stops simulated device and frees all needed resources.
+	 */
+	~CDCSimulator();
+
+	/**
+	 * Returns name of port to pass to CDCImpl constructor.
+	 * @return name of port
+	 */
+	const char* getPortName(void);
+
+	/**
+	 * Creates transport connected to the simulated device, which can be
+	 * passed to CDCImpl constructor instead of port name. Unlike the port
+	 * name, the transport skips settings of serial port and their delay.
+	 * @return transport connected to the simulated device
+	 * @throw CDCImplException if the transport cannot be created
+	 */
+	CDCTransport* createTransport(void);
+
+	/**
+	 * Changes behaviour of simulated device.
+	 * @param options new behaviour of simulated device
+	 */
+	void setOptions(const SimulatorOptions& options);
+
+	/**
+	 * Returns statistics of simulated device.
+	 * @return statistics of simulated device
+	 */
+	SimulatorStats getStats(void);
+};
+
+#endif // __CDCSimulator_h_
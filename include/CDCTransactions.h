@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Transactions of DPA requests and their responses.
+ *
+ * @file		CDCTransactions.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCTransactions_h_
+#define __CDCTransactions_h_
+
+#include <CDCImpl.h>
+#include <CDCResult.h>
+#include "CDCTypes.h"
+#include <functional>
+#include <future>
+
+/**
+ * Final state of transaction.
+ */
+enum class TransactionStatus {
+	OK,                 /**< response (or confirmation of broadcast) was received */
+	TIMEOUT,            /**< response was not received within the timeout */
+	SEND_FAILED,        /**< request was not accepted by DS command */
+	INVALID_REQUEST,    /**< request is shorter than DPA header */
+	ABORTED             /**< transactions object was destroyed */
+};
+
+/**
+ * Result of transaction.
+ */
+struct TransactionResult {
+	TransactionStatus status;   /**< final state of the transaction */
+	CDCStatus sendStatus;       /**< error of DS command, if it failed */
+	DSResponse dsResponse;      /**< response to DS command, @c ERR if it was not sent */
+	ustring confirmation;       /**< DPA confirmation, empty if not received */
+	ustring response;           /**< DPA response, empty if not received */
+
+	TransactionResult()
+		:status(TransactionStatus::OK), dsResponse(OK) {}
+};
+
+/**
+ * Callback of finished transaction. It is called by the reading thread of
+ * CDCImpl, by the timer thread or by the sending thread, so it must not
+ * block.
+ */
+typedef std::function<void(const TransactionResult&)> TransactionCallbackF;
+
+/**
+ * Forward declaration of CDCTransactions implementation class.
+ */
+class CDCTransactionsPrivate;
+
+/**
+ * Correlates DPA requests sent by DS command with DPA responses received
+ * in DR messages. Pending requests are keyed by NADR, PNUM and PCMD (without
+ * response flag) in hashed table, requests with the same key are matched
+ * in order of sending. Timeouts are handled by timer wheel, so many
+ * requests can be in flight at once. Request to broadcast address
+ * finishes by its confirmation, as no response is sent.
+ *
+ * The object adds itself as asynchronous listener of specified CDCImpl,
+ * next to listeners of the application. DR messages, which do not match any pending request, are passed
+ * to the listener set by @c setUnmatchedListener.
+ */
+class CDCTransactions {
+private:
+	// Pointer to implementation object(d-pointer).
+	CDCTransactionsPrivate* implObj;
+
+public:
+	/**
+	 * Creates transactions over specified communication object.
+	 * @param cdc communication object, it must outlive the transactions
+	 * @param tickInterval resolution of timeouts in milliseconds
+	 */
+	CDCTransactions(CDCImpl& cdc, unsigned int tickInterval = 10);
+
+	/**
+	 * Unregisters the listener and aborts pending transactions.
+	 */
+	~CDCTransactions();
+
+	/**
+	 * Sends DPA request and returns future of its result.
+	 * @param request DPA request - NADR, PNUM, PCMD, HWPID and data
+	 * @param timeout maximal time of waiting for the response [ms]
+	 * @return future result of the transaction
+	 */
+	std::future<TransactionResult> send(const ustring& request, unsigned int timeout);
+
+	/**
+	 * Sends DPA request and calls specified callback with its result.
+	 * @param request DPA request - NADR, PNUM, PCMD, HWPID and data
+	 * @param timeout maximal time of waiting for the response [ms]
+	 * @param callback callback of finished transaction
+	 */
+	void send(const ustring& request, unsigned int timeout, TransactionCallbackF callback);
+
+	/**
+	 * Returns number of pending transactions.
+	 * @return number of pending transactions
+	 */
+	unsigned int getPendingCount(void);
+
+	/**
+	 * Sets listener of DR messages, which do not belong to any pending
+	 * transaction.
+	 * @param unmatchedListener listener of unmatched DR messages
+	 */
+	void setUnmatchedListener(AsyncMsgListenerF unmatchedListener);
+};
+
+#endif // __CDCTransactions_h_
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Transports of the byte stream between CDCImpl and USB device.
+ *
+ * @file		CDCTransport.h
+ * @version		1.0.0
+ * @date		18.10.2026
+ */
+
+#ifndef __CDCTransport_h_
+#define __CDCTransport_h_
+
+/**
+ * Byte stream connected to USB device. CDCImpl waits for incoming data
+ * on the handle returned by @c getHandle, so it must be pollable
+ * (file descriptor on Linux). Custom transports are supported on Linux only.
+ */
+class CDCTransport {
+public:
+	/**
+	 * Returns pollable handle of the transport.
+	 * @return handle of the transport
+	 */
+	virtual int getHandle(void) = 0;
+
+	/**
+	 * Reads available data into specified buffer.
+	 * @param buf buffer for read data
+	 * @param buflen size of the buffer
+	 * @return number of read bytes
+	 * @return @c -1 on error, @c errno is set
+	 */
+	virtual int read(unsigned char* buf, unsigned int buflen) = 0;
+
+	/**
+	 * Writes specified data.
+	 * @param data data to write
+	 * @param dlen length of data to write
+	 * @return number of written bytes
+	 * @return @c -1 on error, @c errno is set
+	 */
+	virtual int write(const unsigned char* data, unsigned int dlen) = 0;
+
+	virtual ~CDCTransport() {}
+};
+
+/**
+ * Transport over file descriptor (serial port, pseudo-terminal, pipe...).
+ */
+class CDCFdTransport : public CDCTransport {
+private:
+	int fd;
+	bool ownsFd;
+
+public:
+	/**
+	 * Creates transport over specified file descriptor.
+	 * @param fd file descriptor
+	 * @param ownsFd if @c true, the descriptor is closed by the transport
+	 */
+	CDCFdTransport(int fd, bool ownsFd = true);
+
+	~CDCFdTransport();
+
+	int getHandle(void);
+	int read(unsigned char* buf, unsigned int buflen);
+	int write(const unsigned char* data, unsigned int dlen);
+};
+
+#endif // __CDCTransport_h_
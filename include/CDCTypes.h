@@ -27,10 +27,14 @@
 #define __CDCTypes_h_
 
 #include <string>
+#include <string_view>
 
 /** String, which consists of unsigned chars. */
 typedef std::basic_string<unsigned char> ustring;
 
+/** Read-only view of unsigned chars, refers data owned by other string. */
+typedef std::basic_string_view<unsigned char> ustring_view;
+
 /** Message types. */
 enum MessageType {
 	MSG_ERROR, MSG_TEST, MSG_RES_USB, MSG_RES_TR, MSG_USB_INFO,
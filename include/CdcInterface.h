@@ -45,6 +45,21 @@ struct DeviceInfo {
     unsigned int snLen;        /**< length of serial number information */
 };
 
+/**
+ * USB device identification with inline storage. Response information
+ * of "I-command". All fields are NUL-terminated, longer fields are
+ * truncated to @c FIELD_SIZE - 1 characters.
+ */
+struct USBDeviceInfo {
+    static const unsigned int FIELD_SIZE = 32;
+    char type[FIELD_SIZE];              /**< device type */
+    unsigned int typeLen;               /**< length of device type information */
+    char firmwareVersion[FIELD_SIZE];   /**< firmware version */
+    unsigned int fwLen;                 /**< length of firmware version information */
+    char serialNumber[FIELD_SIZE];      /**< serial number */
+    unsigned int snLen;                 /**< length of serial number information */
+};
+
 /**
  * Information about TR module identification inside the USB device.
  * IQRF OS User's guide (chapter Identification -> Module Data).
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "CDCTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+* Allocator taking memory from memory resource. Unlike polymorphic_allocator,
+* it propagates on move and swap, so buffers of different containers are
+* exchanged without copying, whatever resources they use.
+*/
+template <typename T>
+class CDCAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    CDCAllocator() noexcept
+        :resource(std::pmr::get_default_resource()) {}
+
+    CDCAllocator(std::pmr::memory_resource* resource) noexcept
+        :resource(resource) {}
+
+    template <typename U>
+    CDCAllocator(const CDCAllocator<U>& other) noexcept
+        :resource(other.getResource()) {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    std::pmr::memory_resource* getResource(void) const noexcept
+    {
+        return resource;
+    }
+
+private:
+    std::pmr::memory_resource* resource;
+};
+
+template <typename T, typename U>
+bool operator==(const CDCAllocator<T>& first, const CDCAllocator<U>& second) noexcept
+{
+    return first.getResource() == second.getResource() || first.getResource()->is_equal(*second.getResource());
+}
+
+template <typename T, typename U>
+bool operator!=(const CDCAllocator<T>& first, const CDCAllocator<U>& second) noexcept
+{
+    return !(first == second);
+}
+
+/* Bytes of frames, allocated from memory resource of CDCImpl. */
+typedef std::basic_string<unsigned char, std::char_traits<unsigned char>, CDCAllocator<unsigned char>> FrameBytes;
+
+/*
+* Pool of byte buffers preallocated at initialization. Buffers are moved
+* out of the pool and back, so their memory is reused. Pool, which is
+* not initialized, holds no buffers - acquired buffers are empty and
+* released ones are freed.
+*/
+class CDCBufferPool {
+public:
+    CDCBufferPool()
+        :bufferCount(0), bufferCapacity(0), misses(0) {}
+
+    /* Preallocates specified count of buffers with specified capacity from the resource. */
+    void init(size_t count, size_t capacity, std::pmr::memory_resource* resource)
+    {
+        std::lock_guard<std::mutex> lck(csPool);
+        CDCAllocator<FrameBytes> allocator(resource);
+        buffers = std::vector<FrameBytes, CDCAllocator<FrameBytes>>(allocator);
+        bufferCapacity = capacity;
+        buffers.reserve(count);
+        while (buffers.size() < count) {
+            buffers.push_back(FrameBytes(allocator));
+            buffers.back().reserve(capacity);
+        }
+        bufferCount = count;
+    }
+
+    /* Moves empty buffer out of the pool into specified one. */
+    void acquire(FrameBytes& buffer)
+    {
+        if (bufferCount == 0)
+            return;
+
+        std::lock_guard<std::mutex> lck(csPool);
+        if (buffers.empty()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer.swap(buffers.back());
+        buffers.pop_back();
+    }
+
+    /* Moves specified buffer back to the pool, if it is not full. */
+    void release(FrameBytes& buffer)
+    {
+        if (bufferCount == 0 || buffer.capacity() < bufferCapacity)
+            return;
+
+        std::lock_guard<std::mutex> lck(csPool);
+        if (buffers.size() == bufferCount)
+            return;
+
+        buffer.clear();
+        buffers.push_back(std::move(buffer));
+    }
+
+    /* Returns count of buffers requested from exhausted pool. */
+    unsigned long long getMisses(void) const
+    {
+        return misses.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::mutex csPool;
+    std::vector<FrameBytes, CDCAllocator<FrameBytes>> buffers;
+    size_t bufferCount;
+    size_t bufferCapacity;
+    std::atomic<unsigned long long> misses;
+};
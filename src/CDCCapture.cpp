@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CDCCapture.h>
+#include <CDCImplException.h>
+#include <cstring>
+
+/* Magic string at the beginning of each capture file. */
+static const char CAPTURE_MAGIC[] = "CDCCAP";
+static const size_t CAPTURE_MAGIC_LEN = 6;
+
+/* Current version of capture file format. */
+static const unsigned char CAPTURE_VERSION = 1;
+
+/* Size of record header - direction, timestamp and data length. */
+static const size_t RECORD_HEADER_LEN = 1 + 8 + 4;
+
+/* Stores specified value in little endian order. */
+static void putLE(unsigned char* dest, unsigned long long value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        dest[i] = static_cast<unsigned char>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+/* Loads value stored in little endian order. */
+static unsigned long long getLE(const unsigned char* src, size_t bytes)
+{
+    unsigned long long value = 0;
+    for (size_t i = bytes; i > 0; i--)
+        value = (value << 8) | src[i - 1];
+    return value;
+}
+
+//////////////////////////////////////
+// class CDCCaptureWriter
+//////////////////////////////////////
+CDCCaptureWriter::CDCCaptureWriter(const char* fileName)
+    :file(fileName, std::ios::out | std::ios::binary | std::ios::trunc)
+{
+    if (!file.is_open())
+        THROW_EXCEPT(CDCImplException, "Capture file " << fileName << " cannot be created");
+
+    unsigned char header[CAPTURE_MAGIC_LEN + 2];
+    memcpy(header, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN);
+    header[CAPTURE_MAGIC_LEN] = CAPTURE_VERSION;
+    header[CAPTURE_MAGIC_LEN + 1] = 0;
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    startTime = std::chrono::steady_clock::now();
+}
+
+CDCCaptureWriter::~CDCCaptureWriter()
+{
+    file.close();
+}
+
+void CDCCaptureWriter::write(CaptureDirection direction, const unsigned char* data, size_t dlen)
+{
+    std::lock_guard<std::mutex> lck(csFile);
+
+    unsigned long long timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    unsigned char header[RECORD_HEADER_LEN];
+    header[0] = static_cast<unsigned char>(direction);
+    putLE(header + 1, timestamp, 8);
+    putLE(header + 9, dlen, 4);
+
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data), dlen);
+    file.flush();
+}
+
+//////////////////////////////////////
+// class CDCCaptureReader
+//////////////////////////////////////
+CDCCaptureReader::CDCCaptureReader(const char* fileName)
+    :file(fileName, std::ios::in | std::ios::binary)
+{
+    if (!file.is_open())
+        THROW_EXCEPT(CDCImplException, "Capture file " << fileName << " cannot be opened");
+
+    char header[CAPTURE_MAGIC_LEN + 2];
+    file.read(header, sizeof(header));
+    if (!file || memcmp(header, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) != 0)
+        THROW_EXCEPT(CDCImplException, "File " << fileName << " is not a capture file");
+
+    if (static_cast<unsigned char>(header[CAPTURE_MAGIC_LEN]) != CAPTURE_VERSION)
+        THROW_EXCEPT(CDCImplException, "Unsupported capture file version "
+            << static_cast<int>(header[CAPTURE_MAGIC_LEN]));
+}
+
+CDCCaptureReader::~CDCCaptureReader()
+{
+    file.close();
+}
+
+bool CDCCaptureReader::next(CaptureRecord& record)
+{
+    unsigned char header[RECORD_HEADER_LEN];
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (file.gcount() == 0)
+        return false;
+
+    if (static_cast<size_t>(file.gcount()) != sizeof(header))
+        THROW_EXCEPT(CDCImplException, "Truncated capture record header");
+
+    if (header[0] != CAPTURE_TX && header[0] != CAPTURE_RX)
+        THROW_EXCEPT(CDCImplException, "Unknown capture record direction " << static_cast<int>(header[0]));
+
+    record.direction = static_cast<CaptureDirection>(header[0]);
+    record.timestamp = getLE(header + 1, 8);
+
+    size_t dlen = static_cast<size_t>(getLE(header + 9, 4));
+    record.data.resize(dlen);
+    file.read(reinterpret_cast<char*>(&record.data[0]), dlen);
+    if (static_cast<size_t>(file.gcount()) != dlen)
+        THROW_EXCEPT(CDCImplException, "Truncated capture record data");
+
+    return true;
+}
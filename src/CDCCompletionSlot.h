@@ -0,0 +1,195 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#ifdef WIN32
+#include <condition_variable>
+#include <mutex>
+#else
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+/*
+* Slot passing values from one producer thread to one waiting consumer.
+* The value is moved in and out of the slot, the state is kept in atomic
+* word, so the handoff needs no lock and no system call. Only sleeping
+* consumer is woken up by futex (condition variable on Windows).
+* Unconsumed value is overwritten by the next one.
+*/
+template <typename T>
+class CDCCompletionSlot {
+public:
+    /* Result of waiting. */
+    enum WaitResult {
+        WAIT_OK,            // value was taken
+        WAIT_TIMEOUT,       // no value within timeout
+        WAIT_INTERRUPTED    // interrupt was called
+    };
+
+    CDCCompletionSlot()
+        :state(EMPTY) {}
+
+    /* Drops unconsumed value and interruption, called before new request. */
+    void reset(void)
+    {
+        uint32_t current = state.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t stateValue = current & VALUE_MASK;
+            if (stateValue != FULL && (current & INTERRUPTED) == 0)
+                return;
+
+            uint32_t cleared = (stateValue == FULL)? (EMPTY | (current & WAITING)) : (current & ~INTERRUPTED);
+            if (state.compare_exchange_weak(current, cleared, std::memory_order_acq_rel))
+                return;
+        }
+    }
+
+    /* Moves specified value into the slot and wakes up the consumer. */
+    void post(T&& value)
+    {
+        uint32_t current = state.load(std::memory_order_acquire);
+        for (;;) {
+            // the consumer is moving the previous value out
+            if ((current & VALUE_MASK) == CONSUMING) {
+                std::this_thread::yield();
+                current = state.load(std::memory_order_acquire);
+                continue;
+            }
+
+            uint32_t writing = WRITING | (current & (WAITING | INTERRUPTED));
+            if (state.compare_exchange_weak(current, writing, std::memory_order_acq_rel))
+                break;
+        }
+
+        slotValue = std::move(value);
+
+        uint32_t previous = state.load(std::memory_order_relaxed);
+        while (!state.compare_exchange_weak(previous, FULL | (previous & INTERRUPTED), std::memory_order_release)) {}
+
+        if (previous & WAITING)
+            wake();
+    }
+
+    /* Wakes up the consumer without value. */
+    void interrupt(void)
+    {
+        uint32_t previous = state.fetch_or(INTERRUPTED, std::memory_order_acq_rel);
+        if (previous & WAITING)
+            wake();
+    }
+
+    /*
+    * Waits for value and moves it out of the slot.
+    * @param value taken value
+    * @param timeout maximal time of waiting [ms]
+    */
+    WaitResult wait(T& value, unsigned int timeout)
+    {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout);
+
+        uint32_t current = state.load(std::memory_order_acquire);
+        for (;;) {
+            if (current & INTERRUPTED) {
+                if (state.compare_exchange_weak(current, current & ~(INTERRUPTED | WAITING), std::memory_order_acq_rel))
+                    return WAIT_INTERRUPTED;
+                continue;
+            }
+
+            if ((current & VALUE_MASK) == FULL) {
+                if (!state.compare_exchange_weak(current, CONSUMING, std::memory_order_acq_rel))
+                    continue;
+
+                value = std::move(slotValue);
+                // keeps interruption, which came during moving out
+                state.fetch_and(~VALUE_MASK, std::memory_order_release);
+                return WAIT_OK;
+            }
+
+            // announces sleeping, so that the producer wakes it up
+            if ((current & WAITING) == 0) {
+                if (!state.compare_exchange_weak(current, current | WAITING, std::memory_order_acq_rel))
+                    continue;
+                current |= WAITING;
+            }
+
+            Clock::time_point now = Clock::now();
+            if (now >= deadline) {
+                state.fetch_and(~WAITING, std::memory_order_acq_rel);
+                return WAIT_TIMEOUT;
+            }
+
+            sleep(current, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now));
+            current = state.load(std::memory_order_acquire);
+        }
+    }
+
+private:
+    // values of the state
+    static const uint32_t EMPTY = 0;
+    static const uint32_t WRITING = 1;
+    static const uint32_t FULL = 2;
+    static const uint32_t CONSUMING = 3;
+    static const uint32_t VALUE_MASK = 3;
+
+    // flags of the state
+    static const uint32_t WAITING = 4;
+    static const uint32_t INTERRUPTED = 8;
+
+    std::atomic<uint32_t> state;
+    T slotValue;
+
+#ifdef WIN32
+    std::mutex sleepMutex;
+    std::condition_variable sleepCond;
+
+    void sleep(uint32_t expected, std::chrono::nanoseconds timeout)
+    {
+        std::unique_lock<std::mutex> lck(sleepMutex);
+        sleepCond.wait_for(lck, timeout, [this, expected] { return state.load() != expected; });
+    }
+
+    void wake(void)
+    {
+        std::lock_guard<std::mutex> lck(sleepMutex);
+        sleepCond.notify_one();
+    }
+#else
+    // sleeps, while the state has expected value
+    void sleep(uint32_t expected, std::chrono::nanoseconds timeout)
+    {
+        struct timespec relative;
+        relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+        relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state), FUTEX_WAIT_PRIVATE, expected, &relative, NULL, 0);
+    }
+
+    void wake(void)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+#endif
+};
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CDCDiscovery.h>
+#include <CDCImpl.h>
+#include <thread>
+
+/*
+ * Probes one port.
+ * @return true if the device on the port responds
+ */
+static bool probePort(const std::string& portName, const CDCImplOptions& implOptions,
+    DiscoveredDevice& device)
+{
+    try {
+        CDCImpl cdc(portName.c_str(), implOptions);
+
+        CDCResult<bool> testResult = cdc.tryTest();
+        if (!testResult || !testResult.value())
+            return false;
+
+        device.portName = portName;
+        device.deviceInfo = cdc.getCachedUSBDeviceInfo();
+        return true;
+    } catch (CDCImplException&) {
+        // port cannot be opened or the device does not respond
+        return false;
+    }
+}
+
+std::vector<DiscoveredDevice> probeDevicePorts(const std::vector<std::string>& portNames,
+    const DiscoveryOptions& options)
+{
+    CDCImplOptions implOptions;
+    implOptions.responseTimeout = options.probeTimeout;
+    implOptions.settleDelay = options.settleDelay;
+
+    std::vector<DiscoveredDevice> devices(portNames.size());
+    std::vector<char> responded(portNames.size(), false);
+
+    // each port is probed by its own thread, so the whole probing takes
+    // only as long as the slowest port
+    std::vector<std::thread> probes;
+    for (size_t i = 0; i < portNames.size(); i++) {
+        probes.push_back(std::thread([&, i] {
+            responded[i] = probePort(portNames[i], implOptions, devices[i]);
+        }));
+    }
+
+    for (size_t i = 0; i < probes.size(); i++)
+        probes[i].join();
+
+    std::vector<DiscoveredDevice> respondedDevices;
+    for (size_t i = 0; i < devices.size(); i++) {
+        if (responded[i])
+            respondedDevices.push_back(devices[i]);
+    }
+    return respondedDevices;
+}
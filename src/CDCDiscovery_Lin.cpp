@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CDCDiscovery.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+/* Directory with tty devices. */
+static const char* SYS_CLASS_TTY = "/sys/class/tty";
+
+/* Directory of all devices, USB device is never above it. */
+static const char* SYS_DEVICES = "/sys/devices";
+
+/*
+ * Reads hexadecimal ID from specified sysfs attribute file.
+ * @return false if the file cannot be read
+ */
+static bool readId(const fs::path& path, unsigned int& id)
+{
+    std::ifstream file(path);
+    std::string idStr;
+    if (!(file >> idStr))
+        return false;
+
+    id = static_cast<unsigned int>(strtoul(idStr.c_str(), NULL, 16));
+    return true;
+}
+
+/*
+ * Finds USB device directory of specified tty device - the nearest parent
+ * directory with idVendor and idProduct attributes.
+ * @return false if the tty device is not on USB
+ */
+static bool findUSBDevice(const fs::path& ttyDevice, unsigned int& vendorId, unsigned int& productId)
+{
+    std::error_code error;
+    fs::path devicePath = fs::canonical(ttyDevice, error);
+    if (error)
+        return false;
+
+    for (; devicePath.string().size() > strlen(SYS_DEVICES); devicePath = devicePath.parent_path()) {
+        if (readId(devicePath / "idVendor", vendorId) && readId(devicePath / "idProduct", productId))
+            return true;
+    }
+    return false;
+}
+
+std::vector<std::string> findDevicePorts(const DiscoveryOptions& options)
+{
+    std::vector<std::string> portNames;
+
+    std::error_code error;
+    for (fs::directory_iterator entry(SYS_CLASS_TTY, error); !error && entry != fs::directory_iterator();
+            entry.increment(error))
+    {
+        // virtual terminals have no device
+        fs::path ttyDevice = entry->path() / "device";
+        if (!fs::exists(ttyDevice, error))
+            continue;
+
+        unsigned int vendorId = 0;
+        unsigned int productId = 0;
+        if (!findUSBDevice(ttyDevice, vendorId, productId))
+            continue;
+
+        if (options.vendorId != 0 && options.vendorId != vendorId)
+            continue;
+        if (options.productId != 0 && options.productId != productId)
+            continue;
+
+        portNames.push_back("/dev/" + entry->path().filename().string());
+    }
+
+    std::sort(portNames.begin(), portNames.end());
+    return portNames;
+}
+
+std::vector<DiscoveredDevice> discoverDevices(const DiscoveryOptions& options)
+{
+    return probeDevicePorts(findDevicePorts(options), options);
+}
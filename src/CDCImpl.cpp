@@ -18,8 +18,10 @@
 #include <CDCImpl.h>
 #include <CDCImplPri.h>
 #include <CDCMessageParser.h>
+#include <CDCMessageParserException.h>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 using namespace std;
 
@@ -32,19 +34,60 @@ inline const unsigned char* uchar_str(const char* s)
 }
 
 /* --- PUBLIC INTERFACE */
+/*
+* Instance is placed into memory of the resource, so that objects of
+* different devices do not share the allocator.
+*/
+template <typename... Args>
+CDCImplPrivate* CDCImplPrivate::create(std::pmr::memory_resource* resource, Args&&... args)
+{
+    if (resource == NULL)
+        resource = std::pmr::get_default_resource();
+
+    void* memory = resource->allocate(sizeof(CDCImplPrivate), alignof(CDCImplPrivate));
+    try {
+        return new (memory) CDCImplPrivate(std::forward<Args>(args)...);
+    } catch (...) {
+        resource->deallocate(memory, sizeof(CDCImplPrivate), alignof(CDCImplPrivate));
+        throw;
+    }
+}
+
+void CDCImplPrivate::destroy(CDCImplPrivate* implObj)
+{
+    std::pmr::memory_resource* resource = implObj->frameAllocator.getResource();
+    implObj->~CDCImplPrivate();
+    resource->deallocate(implObj, sizeof(CDCImplPrivate), alignof(CDCImplPrivate));
+}
+
 CDCImpl::CDCImpl()
 {
-    implObj = ant_new CDCImplPrivate();
+    implObj = CDCImplPrivate::create(NULL);
 }
 
 CDCImpl::CDCImpl(const char* commPort)
 {
-    implObj = ant_new CDCImplPrivate(commPort);
+    implObj = CDCImplPrivate::create(NULL, commPort);
+}
+
+CDCImpl::CDCImpl(const char* commPort, const CDCImplOptions& options)
+{
+    implObj = CDCImplPrivate::create(options.memoryResource, commPort, options);
+}
+
+CDCImpl::CDCImpl(CDCTransport* transport)
+{
+    implObj = CDCImplPrivate::create(NULL, transport);
+}
+
+CDCImpl::CDCImpl(CDCTransport* transport, const CDCImplOptions& options)
+{
+    implObj = CDCImplPrivate::create(options.memoryResource, transport, options);
 }
 
 CDCImpl::~CDCImpl()
 {
-    delete implObj;
+    CDCImplPrivate::destroy(implObj);
 }
 
 /*
@@ -65,12 +108,14 @@ bool CDCImpl::test()
 
 void CDCImpl::resetUSBDevice()
 {
+    implObj->invalidateIdentification(true, true);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_RES_USB, uchar_str(""));
     implObj->processCommand(cmd);
 }
 
 void CDCImpl::resetTRModule()
 {
+    implObj->invalidateIdentification(false, true);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_RES_TR, uchar_str(""));
     implObj->processCommand(cmd);
 }
@@ -84,37 +129,51 @@ void CDCImpl::indicateConnectivity()
 DeviceInfo* CDCImpl::getUSBDeviceInfo(void)
 {
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_USB_INFO, uchar_str(""));
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedDeviceInfo(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedDeviceInfo(response.message);
 }
 
 ModuleInfo* CDCImpl::getTRModuleInfo(void)
 {
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_TR_INFO, uchar_str(""));
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedModuleInfo(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedModuleInfo(response.message);
+}
+
+USBDeviceInfo CDCImpl::getCachedUSBDeviceInfo(void)
+{
+    return implObj->getUSBDeviceInfo();
+}
+
+ModuleInfo CDCImpl::getCachedTRModuleInfo(void)
+{
+    return implObj->getTRModuleInfo();
 }
 
 SPIStatus CDCImpl::getStatus(void)
 {
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_SPI_STAT, uchar_str(""));
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedSPIStatus(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->parseStatusResponse(response);
 }
 
 DSResponse CDCImpl::sendData(const unsigned char* data, unsigned int dlen)
 {
-    ustring dataStr(data, dlen);
-    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, dataStr);
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedDSResponse(implObj->lastResponse.message);
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, data, dlen);
+    CDCResult<DSResponse> result = implObj->processDataSend(cmd);
+    if (!result)
+        implObj->throwError(result);
+    return result.value();
 }
 
 DSResponse CDCImpl::sendData(const std::basic_string<unsigned char>& data)
 {
-    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, data);
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedDSResponse(implObj->lastResponse.message);
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, data.data(),
+        static_cast<unsigned int>(data.size()));
+    CDCResult<DSResponse> result = implObj->processDataSend(cmd);
+    if (!result)
+        implObj->throwError(result);
+    return result.value();
 }
 
 void CDCImpl::switchToCustom(void)
@@ -127,15 +186,17 @@ void CDCImpl::switchToCustom(void)
 PTEResponse CDCImpl::enterProgrammingMode(void)
 {
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_MODE_PROGRAM, uchar_str(""));
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedPEResponse(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedPEResponse(response.message);
 }
 
 PTEResponse CDCImpl::terminateProgrammingMode(void)
 {
+    // TR module can be programmed with another OS
+    implObj->invalidateIdentification(false, true);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_MODE_NORMAL, uchar_str(""));
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedPTResponse(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedPTResponse(response.message);
 }
 
 static void verifyUpload(unsigned char target, const std::basic_string<unsigned char>& data)
@@ -165,8 +226,8 @@ PMResponse CDCImpl::upload(unsigned char target, const unsigned char* data, unsi
     verifyUpload(target, data);
     dataStr.insert(dataStr.begin(), target);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedPMResponse(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedPMResponse(response.message);
 }
 
 PMResponse CDCImpl::upload(unsigned char target, const std::basic_string<unsigned char>& data)
@@ -175,8 +236,8 @@ PMResponse CDCImpl::upload(unsigned char target, const std::basic_string<unsigne
     verifyUpload(target, data);
     dataStr.insert(dataStr.begin(), target);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
-    implObj->processCommand(cmd);
-    return implObj->msgParser->getParsedPMResponse(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    return implObj->msgParser->getParsedPMResponse(response.message);
 }
 
 PMResponse CDCImpl::download(unsigned char target, const unsigned char* inputData, unsigned int inputDlen,
@@ -187,9 +248,9 @@ PMResponse CDCImpl::download(unsigned char target, const unsigned char* inputDat
     verifyDownload(target);
     dataStr.insert(dataStr.begin(), target);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
-    implObj->processCommand(cmd);
-    if (implObj->lastResponse.parseResult.msgType == MSG_DOWNLOAD_DATA) {
-        dataStr = implObj->msgParser->getParsedPMData(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    if (response.parseResult.msgType == MSG_DOWNLOAD_DATA) {
+        dataStr = implObj->msgParser->getParsedPMData(response.message);
         if (dataStr.length() >= outputDlen) {
             std::ostringstream msg;
             msg << "Receive of download message failed. Data are longer than available data buffer - " << dataStr.length() << " >= " << outputDlen << "!";
@@ -199,7 +260,7 @@ PMResponse CDCImpl::download(unsigned char target, const unsigned char* inputDat
         len = static_cast<unsigned int>(dataStr.length());
         return PMResponse::OK;
     } else {
-        return implObj->msgParser->getParsedPMResponse(implObj->lastResponse.message);
+        return implObj->msgParser->getParsedPMResponse(response.message);
     }
 }
 
@@ -210,14 +271,222 @@ PMResponse CDCImpl::download(unsigned char target, const std::basic_string<unsig
     verifyDownload(target);
     dataStr.insert(dataStr.begin(), target);
     CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
-    implObj->processCommand(cmd);
-    if (implObj->lastResponse.parseResult.msgType == MSG_DOWNLOAD_DATA) {
-        dataStr = implObj->msgParser->getParsedPMData(implObj->lastResponse.message);
+    CDCImplPrivate::ParsedMessage response = implObj->processCommand(cmd);
+    if (response.parseResult.msgType == MSG_DOWNLOAD_DATA) {
+        dataStr = implObj->msgParser->getParsedPMData(response.message);
         outputData = dataStr;
         return PMResponse::OK;
     } else {
-        return implObj->msgParser->getParsedPMResponse(implObj->lastResponse.message);
+        return implObj->msgParser->getParsedPMResponse(response.message);
+    }
+}
+
+CDCResult<bool> CDCImpl::tryTest(void) noexcept
+{
+    try {
+        CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_TEST, uchar_str(""));
+        CDCImplPrivate::ParsedMessage response;
+        CDCStatus status = implObj->tryProcessCommand(cmd, response);
+        if (!status)
+            return status;
+        return true;
+    } catch (...) {
+        return CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+    }
+}
+
+CDCResult<SPIStatus> CDCImpl::tryGetStatus(void) noexcept
+{
+    try {
+        CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_SPI_STAT, uchar_str(""));
+        CDCImplPrivate::ParsedMessage response;
+        CDCStatus status = implObj->tryProcessCommand(cmd, response);
+        if (!status)
+            return status;
+        return implObj->parseStatusResponse(response);
+    } catch (...) {
+        return CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+    }
+}
+
+CDCResult<DSResponse> CDCImpl::trySendData(const unsigned char* data, unsigned int dlen) noexcept
+{
+    try {
+        CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, data, dlen);
+        return implObj->processDataSend(cmd);
+    } catch (...) {
+        return CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+    }
+}
+
+CDCResult<DSResponse> CDCImpl::trySendData(const std::basic_string<unsigned char>& data) noexcept
+{
+    return trySendData(data.data(), static_cast<unsigned int>(data.size()));
+}
+
+std::vector<CDCResult<DSResponse>> CDCImpl::sendDataBatch(
+        const std::vector<std::basic_string<unsigned char>>& frames)
+{
+    std::vector<CDCResult<DSResponse>> results(frames.size(), CDCStatus(CDCErrorCode::INTERNAL_ERROR));
+    try {
+        implObj->processDataSendBatch(frames, results);
+    } catch (...) {
+        // results of frames, which were not finished, remain INTERNAL_ERROR
+    }
+    return results;
+}
+
+CDCResult<PMResponse> CDCImpl::tryUpload(unsigned char target, const unsigned char* data, unsigned int dlen) noexcept
+{
+    if ((target & 0x80) == 0)
+        return CDCStatus(CDCErrorCode::INVALID_ARGUMENT);
+
+    try {
+        ustring dataStr(data, dlen);
+        dataStr.insert(dataStr.begin(), target);
+        CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
+        CDCImplPrivate::ParsedMessage response;
+        CDCStatus status = implObj->tryProcessCommand(cmd, response);
+        if (!status)
+            return status;
+        return implObj->msgParser->getParsedPMResponse(response.message);
+    } catch (...) {
+        return CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+    }
+}
+
+void CDCImpl::sendDataAsync(const unsigned char* data, unsigned int dlen, DataSendCallbackF callback)
+{
+    CDCImplPrivate* impl = implObj;
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_DATA_SEND, data, dlen);
+    implObj->queueCommand(cmd, [impl, callback](const CDCStatus& status, CDCImplPrivate::ParsedMessage& response) {
+        CDCResult<DSResponse> result = status;
+        if (status) {
+            try {
+                result = impl->msgParser->getParsedDSResponse(response.message);
+            } catch (...) {
+                result = CDCStatus(CDCErrorCode::BAD_RESPONSE);
+            }
+            impl->requestStatusRefresh();
+        }
+        if (callback)
+            callback(result);
+    });
+}
+
+void CDCImpl::sendDataAsync(const std::basic_string<unsigned char>& data, DataSendCallbackF callback)
+{
+    sendDataAsync(data.data(), static_cast<unsigned int>(data.size()), callback);
+}
+
+void CDCImpl::getStatusAsync(StatusCallbackF callback)
+{
+    CDCImplPrivate* impl = implObj;
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_SPI_STAT, uchar_str(""));
+    implObj->queueCommand(cmd, [impl, callback](const CDCStatus& status, CDCImplPrivate::ParsedMessage& response) {
+        CDCResult<SPIStatus> result = status;
+        if (status) {
+            try {
+                result = impl->parseStatusResponse(response);
+            } catch (...) {
+                result = CDCStatus(CDCErrorCode::BAD_RESPONSE);
+            }
+        }
+        if (callback)
+            callback(result);
+    });
+}
+
+void CDCImpl::uploadAsync(unsigned char target, const std::basic_string<unsigned char>& data,
+        UploadCallbackF callback)
+{
+    if ((target & 0x80) == 0) {
+        if (callback)
+            callback(CDCStatus(CDCErrorCode::INVALID_ARGUMENT));
+        return;
+    }
+
+    ustring dataStr = data;
+    dataStr.insert(dataStr.begin(), target);
+
+    CDCImplPrivate* impl = implObj;
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
+    implObj->queueCommand(cmd, [impl, callback](const CDCStatus& status, CDCImplPrivate::ParsedMessage& response) {
+        CDCResult<PMResponse> result = status;
+        if (status) {
+            try {
+                result = impl->msgParser->getParsedPMResponse(response.message);
+            } catch (...) {
+                result = CDCStatus(CDCErrorCode::BAD_RESPONSE);
+            }
+        }
+        if (callback)
+            callback(result);
+    });
+}
+
+void CDCImpl::downloadAsync(unsigned char target, const std::basic_string<unsigned char>& inputData,
+        DownloadCallbackF callback)
+{
+    if ((target & 0x80) != 0) {
+        if (callback)
+            callback(CDCStatus(CDCErrorCode::INVALID_ARGUMENT), ustring());
+        return;
     }
+
+    ustring dataStr = inputData;
+    dataStr.insert(dataStr.begin(), target);
+
+    CDCImplPrivate* impl = implObj;
+    CDCImplPrivate::Command cmd = implObj->constructCommand(MSG_UPLOAD_DOWNLOAD, dataStr);
+    implObj->queueCommand(cmd, [impl, callback](const CDCStatus& status, CDCImplPrivate::ParsedMessage& response) {
+        CDCResult<PMResponse> result = status;
+        ustring outputData;
+        if (status) {
+            try {
+                if (response.parseResult.msgType == MSG_DOWNLOAD_DATA) {
+                    outputData = impl->msgParser->getParsedPMData(response.message);
+                    result = PMResponse::OK;
+                } else {
+                    result = impl->msgParser->getParsedPMResponse(response.message);
+                }
+            } catch (...) {
+                result = CDCStatus(CDCErrorCode::BAD_RESPONSE);
+            }
+        }
+        if (callback)
+            callback(result, outputData);
+    });
+}
+
+int CDCImpl::getPollHandle(void)
+{
+    return implObj->getPollHandle();
+}
+
+bool CDCImpl::isWritePending(void)
+{
+    return implObj->isWritePending();
+}
+
+int CDCImpl::getTimerTimeout(void)
+{
+    return implObj->getTimerTimeout();
+}
+
+CDCStatus CDCImpl::onReadable(void)
+{
+    return implObj->onReadable();
+}
+
+CDCStatus CDCImpl::onWritable(void)
+{
+    return implObj->writePendingCommand();
+}
+
+void CDCImpl::onTimer(void)
+{
+    implObj->processPendingTimeout();
 }
 
 bool CDCImpl::isReceptionStopped(void)
@@ -233,6 +502,78 @@ std::string CDCImpl::getLastReceptionError(void)
     return implObj->cloneLastReceptionError();
 }
 
+void CDCImpl::setPacing(const PacingOptions& options)
+{
+    implObj->setPacing(options);
+}
+
+void CDCImpl::setBusyPoll(const BusyPollOptions& options)
+{
+    implObj->setBusyPoll(options);
+}
+
+CDCMetrics CDCImpl::getMetrics(void)
+{
+    return implObj->getMetrics();
+}
+
+void CDCImpl::startStatusMonitor(unsigned int interval, bool refreshOnTraffic)
+{
+    implObj->startStatusMonitor(interval, refreshOnTraffic);
+}
+
+void CDCImpl::stopStatusMonitor(void)
+{
+    implObj->stopStatusMonitor();
+}
+
+CDCResult<SPIStatus> CDCImpl::getCachedStatus(void) noexcept
+{
+    uint32_t encodedStatus = implObj->cachedStatus.load(std::memory_order_acquire);
+    if (encodedStatus == 0)
+        return CDCStatus(CDCErrorCode::STATUS_UNKNOWN);
+    return CDCImplPrivate::decodeStatus(encodedStatus);
+}
+
+/* Registers user-defined listener of SPI status changes. */
+void CDCImpl::registerStatusListener(SPIStatusListenerF statusListener)
+{
+    implObj->setStatusListener(statusListener);
+}
+
+/* Unregisters listener of SPI status changes. */
+void CDCImpl::unregisterStatusListener(void)
+{
+    implObj->setStatusListener(SPIStatusListenerF());
+}
+
+void CDCImpl::setReconnect(const ReconnectOptions& options)
+{
+    implObj->setReconnect(options);
+}
+
+/* Registers user-defined listener of connection changes. */
+void CDCImpl::registerConnectionListener(ConnectionListenerF connectionListener)
+{
+    implObj->setConnectionListener(connectionListener);
+}
+
+/* Unregisters listener of connection changes. */
+void CDCImpl::unregisterConnectionListener(void)
+{
+    implObj->setConnectionListener(ConnectionListenerF());
+}
+
+void CDCImpl::startCapture(const char* fileName)
+{
+    implObj->startCapture(fileName);
+}
+
+void CDCImpl::stopCapture(void)
+{
+    implObj->stopCapture();
+}
+
 /* Registers user-defined listener of asynchronous messages. */
 void CDCImpl::registerAsyncMsgListener(AsyncMsgListenerF asyncListener)
 {
@@ -245,6 +586,16 @@ void CDCImpl::unregisterAsyncMsgListener(void)
     implObj->setAsyncListener(AsyncMsgListenerF());
 }
 
+unsigned int CDCImpl::addAsyncMsgListener(AsyncMsgListenerF asyncListener, const AsyncMsgFilter& filter)
+{
+    return implObj->addAsyncListener(asyncListener, filter);
+}
+
+void CDCImpl::removeAsyncMsgListener(unsigned int listenerId)
+{
+    implObj->removeAsyncListener(listenerId);
+}
+
 //////////////////////////////////////
 // class CDCImplPrivate
 //////////////////////////////////////
@@ -252,6 +603,7 @@ void CDCImpl::unregisterAsyncMsgListener(void)
 * Creates instance with COM-port set to COM1.
 */
 CDCImplPrivate::CDCImplPrivate()
+  :transport(NULL)
 {
     init();
 }
@@ -259,9 +611,21 @@ CDCImplPrivate::CDCImplPrivate()
 /*
 * Creates instance with specified COM-port.
 * @param commPort COM-port to communicate with
+* @param options options of communication
+*/
+CDCImplPrivate::CDCImplPrivate(const char* portName, const CDCImplOptions& options)
+  :options(options), m_commPort(portName), transport(NULL)
+{
+    init();
+}
+
+/*
+* Creates instance communicating over specified transport.
+* @param transport transport to USB device, the instance takes its ownership
+* @param options options of communication
 */
-CDCImplPrivate::CDCImplPrivate(const char* portName)
-  :m_commPort(portName)
+CDCImplPrivate::CDCImplPrivate(CDCTransport* transport, const CDCImplOptions& options)
+  :options(options), transport(transport)
 {
     init();
 }
@@ -270,29 +634,106 @@ CDCImplPrivate::CDCImplPrivate(const char* portName)
 void CDCImplPrivate::init()
 {
     //createNewLogFile();
-    m_transmitBuffer = ant_new unsigned char[1024];;
-    m_transmitBufferLen = 1024;
+    if (options.memoryResource != NULL)
+        frameAllocator = CDCAllocator<unsigned char>(options.memoryResource);
+    transmitBytes = FrameBytes(frameAllocator);
+    loopReceivedBytes = FrameBytes(frameAllocator);
+    pendingCommands = PendingQueue(frameAllocator);
 
-    portHandle = openPort(m_commPort);
+    openTransport();
 
-    createMyEvent(newMsgEvent);
     createMyEvent(readEndEvent);
     createMyEvent(readStartEvent);
     createMyEvent(readEndResponse);
+    createMyEvent(readWakeEvent);
 
     initMessageHeaders();
-    initLastResponse();
 
     receptionStopped = false;
+    captureWriter = NULL;
+
+    asyncListeners = NULL;
+    nextListenerId = LEGACY_LISTENER_ID + 1;
+    dispatchEpoch = 0;
+    dispatchThread = std::thread::id();
+
+    deviceInfoValid = false;
+    moduleInfoValid = false;
+    identificationGeneration = 0;
+
+    connected = true;
+    connectionGeneration = 0;
+
+    cachedStatus = 0;
+    statusMonitorRunning = false;
+    statusRefreshRequested = false;
+    refreshOnTraffic = false;
+    statusInterval = 0;
+
+    pendingSent = false;
+    pendingWritten = 0;
+    syncCommandActive = false;
+    batchRemaining = 0;
+
+    moduleInfoLength = 0;
+
+    busyPollTime = 0;
+    readerSpinning = false;
+    busyPollRenew = false;
+    metrics.receivedMessages = 0;
+    metrics.blockingReceptions = 0;
+    metrics.spinReceptions = 0;
+    metrics.spinTime = 0;
+    metrics.responses = 0;
+    metrics.responseLatency = 0;
+    metrics.badFrames = 0;
+    metrics.discardedBytes = 0;
 
     msgParser = ant_new CDCMessageParser();
 
+    // buffers of frames are allocated only now
+    if (options.realtime) {
+        framePool.init(options.framePoolSize, FRAME_CAPACITY, frameAllocator.getResource());
+        transmitBytes.reserve(FRAME_CAPACITY);
+        loopReceivedBytes.reserve(RECEIVE_CAPACITY);
+    }
+
+    // the application reads by onReadable
+    if (options.eventLoop)
+        return;
+
     resetMyEvent(readStartEvent);
 
     readMsgHandle = std::thread(&CDCImplPrivate::readMsgThread, this);
+    CDCStatus threadStatus = applyThreadOptions(readMsgHandle, options.readerThread);
 
     // waiting for reading thread
     waitForMyEvent(readStartEvent, TM_START_READ);
+
+    if (!threadStatus) {
+        setMyEvent(readEndEvent);
+        readMsgHandle.join();
+
+        // destructor is not called for object, whose constructor throws
+        releaseResources();
+        THROW_EXCEPT(CDCImplException, "Setting of reading thread failed: " << threadStatus.message());
+    }
+}
+
+/*
+* Frees port, events and parser created by init.
+*/
+void CDCImplPrivate::releaseResources(void)
+{
+    destroyMyEvent(readStartEvent);
+    destroyMyEvent(readEndEvent);
+    destroyMyEvent(readEndResponse);
+    destroyMyEvent(readWakeEvent);
+
+    closeTransport();
+
+    delete msgParser;
+    msgParser = NULL;
 }
 
 /*
@@ -300,6 +741,8 @@ void CDCImplPrivate::init()
 */
 CDCImplPrivate::~CDCImplPrivate()
 {
+    stopStatusMonitor();
+
     setMyEvent(readEndEvent);
 
   //TODO cancel join?
@@ -319,15 +762,14 @@ CDCImplPrivate::~CDCImplPrivate()
     if (readMsgHandle.joinable())
         readMsgHandle.join();
 
-    destroyMyEvent(readStartEvent);
-    destroyMyEvent(newMsgEvent);
-    destroyMyEvent(readEndEvent);
-    destroyMyEvent(readEndResponse);
+    failPendingCommands(CDCStatus(CDCErrorCode::RECEPTION_STOPPED));
 
-    closePort(portHandle);
+    stopCapture();
+    releaseResources();
 
-    delete msgParser;
-    delete[] m_transmitBuffer;
+    delete asyncListeners.load();
+    for (AsyncListenerTable* retired : retiredListeners)
+        delete retired;
 
     //flog.close();
 }
@@ -351,147 +793,387 @@ void CDCImplPrivate::initMessageHeaders(void)
     messageHeaders.insert(pair<MessageType, string>(MSG_DOWNLOAD_DATA, "PM")); // Used only by receive operation
 }
 
-void CDCImplPrivate::initLastResponse(void)
+/*
+* Builds index of subscriptions by PNUM.
+*/
+void CDCImplPrivate::AsyncListenerTable::buildIndex(void)
 {
-    lastResponse.message = ustring(uchar_str(""));
-    lastResponse.parseResult.msgType = MSG_ERROR;
-    lastResponse.parseResult.resultType = PARSE_NOT_COMPLETE;
-    lastResponse.parseResult.lastPosition = 0;
+    for (const AsyncSubscription& subscription : subscriptions) {
+        int peripheral = subscription.filter.peripheral;
+        if (peripheral == AsyncMsgFilter::ANY)
+            anyPeripheral.push_back(&subscription);
+        else if (peripheral >= 0 && peripheral <= 0xFF)
+            byPeripheral[peripheral].push_back(&subscription);
+    }
 }
 
+/*
+* Sets listener registered by registerAsyncMsgListener, the previous one
+* is replaced.
+*/
 void CDCImplPrivate::setAsyncListener(AsyncMsgListenerF listener)
 {
-    std::lock_guard<std::mutex> lck(csAsyncListener);
-    asyncListener = listener;
+    if (listener)
+        addAsyncListener(listener, AsyncMsgFilter(), true);
+    else
+        removeAsyncListener(LEGACY_LISTENER_ID);
 }
 
-bool CDCImplPrivate::getReceptionStopped(void)
+/*
+* Adds listener into new table of listeners.
+* @param legacy listener replaces the one registered by registerAsyncMsgListener
+* @return identifier of the listener
+*/
+unsigned int CDCImplPrivate::addAsyncListener(AsyncMsgListenerF listener, const AsyncMsgFilter& filter,
+    bool legacy)
 {
-    std::lock_guard<std::mutex> lck(csReadingStopped);
-    bool tmpReadingStopped = receptionStopped;
-    return tmpReadingStopped;
-}
+    unsigned int id = LEGACY_LISTENER_ID;
+    std::vector<AsyncListenerTable*> replaced;
+    {
+        std::lock_guard<std::mutex> lck(csAsyncListener);
 
-void CDCImplPrivate::setReceptionStopped(bool value)
-{
-    std::lock_guard<std::mutex> lck(csReadingStopped);
-    receptionStopped = value;
-}
+        if (!legacy)
+            id = nextListenerId++;
 
-/* Sets last reception error according to parameters. */
-void CDCImplPrivate::setLastReceptionError(const std::string& descr)
-{
-    std::lock_guard<std::mutex> lck(csLastRecpError);
-    lastReceptionError = descr;
-}
+        AsyncListenerTable* table = ant_new AsyncListenerTable();
+        AsyncListenerTable* current = asyncListeners.load();
+        if (current != NULL) {
+            for (const AsyncSubscription& subscription : current->subscriptions) {
+                if (subscription.id != id)
+                    table->subscriptions.push_back(subscription);
+            }
+        }
 
-/* Clones last reception error. */
-std::string CDCImplPrivate::cloneLastReceptionError()
-{
-    std::lock_guard<std::mutex> lck(csLastRecpError);
-    std::string ret(lastReceptionError.c_str());
-    return ret;
+        AsyncSubscription subscription;
+        subscription.id = id;
+        subscription.filter = filter;
+        subscription.listener = listener;
+
+        // legacy listener is always the first one
+        if (id == LEGACY_LISTENER_ID)
+            table->subscriptions.insert(table->subscriptions.begin(), subscription);
+        else
+            table->subscriptions.push_back(subscription);
+
+        table->buildIndex();
+        replaced = publishAsyncListeners(table);
+    }
+
+    freeAsyncListeners(replaced);
+    return id;
 }
 
-/*
-* Process specified message. First of all, the message is parsed.
-* If the message is asynchronous message, then  registered listener(if exists)
-* is called. Otherwise, last response is updated and "anew message"
-* signal for main thread is set.
-* @throw CDCReceiveException
-*/
-void CDCImplPrivate::processMessage(ParsedMessage& parsedMessage)
+void CDCImplPrivate::removeAsyncListener(unsigned int id)
 {
-    if (parsedMessage.parseResult.msgType == MSG_ASYNC) {
+    std::vector<AsyncListenerTable*> replaced;
+    {
         std::lock_guard<std::mutex> lck(csAsyncListener);
-        if (asyncListener != NULL) {
-            ustring userData = msgParser->getParsedDRData(parsedMessage.message);
 
-            unsigned char* userDataBytes = ant_new unsigned char[userData.length() + 1];
-            userData.copy(userDataBytes, userData.length());
-            userDataBytes[userData.length()] = '\0';
+        AsyncListenerTable* current = asyncListeners.load();
+        if (current == NULL)
+            return;
 
-            asyncListener(userDataBytes, static_cast<unsigned int>(userData.length()));
-            delete[] userDataBytes;
+        AsyncListenerTable* table = ant_new AsyncListenerTable();
+        for (const AsyncSubscription& subscription : current->subscriptions) {
+            if (subscription.id != id)
+                table->subscriptions.push_back(subscription);
         }
 
-        return;
+        if (table->subscriptions.empty()) {
+            delete table;
+            table = NULL;
+        } else {
+            table->buildIndex();
+        }
+        replaced = publishAsyncListeners(table);
     }
 
-    // copy last parsed message into last response
-    lastResponse.parseResult = parsedMessage.parseResult;
-    lastResponse.message = parsedMessage.message;
-
-    setMyEvent(newMsgEvent);
+    freeAsyncListeners(replaced);
 }
 
 /*
-* Extracts and processes all messages inside the specified buffer.
-* @throw CDCReading Exception
+* Publishes new table of listeners. If the table is replaced by a listener,
+* i.e. by the dispatching thread, the replaced table is kept until next change.
+* Must be called with locked csAsyncListener.
+* @return tables to be freed by freeAsyncListeners
 */
-void CDCImplPrivate::processAllMessages(ustring& msgBuffer)
+std::vector<CDCImplPrivate::AsyncListenerTable*> CDCImplPrivate::publishAsyncListeners(AsyncListenerTable* table)
 {
-    if (msgBuffer.empty())
-        return;
+    std::vector<AsyncListenerTable*> replaced;
+    AsyncListenerTable* previous = asyncListeners.exchange(table);
 
-    ParsedMessage parsedMessage = parseNextMessage(msgBuffer);
-    while (parsedMessage.parseResult.resultType != PARSE_NOT_COMPLETE) {
-        if (parsedMessage.parseResult.resultType == PARSE_BAD_FORMAT) {
-            // throw all bytes from the buffer up to next 0x0D
-            size_t endMsgPos = msgBuffer.find(0x0D, parsedMessage.parseResult.lastPosition);
-            if (endMsgPos == string::npos)
-                msgBuffer.clear();
-            else
-                msgBuffer.erase(0, endMsgPos + 1);
+    if (std::this_thread::get_id() == dispatchThread.load()) {
+        if (previous != NULL)
+            retiredListeners.push_back(previous);
+        return replaced;
+    }
 
-            setLastReceptionError("Bad message format");
-        } else {
-            msgBuffer.erase(0, parsedMessage.parseResult.lastPosition + 1);
-            processMessage(parsedMessage);
-        }
+    replaced.swap(retiredListeners);
+    if (previous != NULL)
+        replaced.push_back(previous);
+    return replaced;
+}
 
-        if (msgBuffer.empty())
-            return;
+/*
+* Frees replaced tables of listeners, as soon as the reading thread does not
+* dispatch with them. Must be called without locked csAsyncListener, as
+* running listener may change listeners too.
+*/
+void CDCImplPrivate::freeAsyncListeners(const std::vector<AsyncListenerTable*>& replaced)
+{
+    if (replaced.empty())
+        return;
 
-        parsedMessage = parseNextMessage(msgBuffer);
+    // dispatching, which has started before the exchange, can use the tables
+    unsigned long long epoch = dispatchEpoch.load();
+    if (epoch % 2 != 0) {
+        while (dispatchEpoch.load() == epoch)
+            std::this_thread::yield();
     }
+
+    for (AsyncListenerTable* table : replaced)
+        delete table;
 }
 
 /*
-* Extracts message string from specified buffer and returns
-* it in the form of string. If the buffer does not contain
-* full message, empty string is returned.
+* Passes data of DR message to listeners, which match its DPA header,
+* in order of their adding. Called by the reading thread only.
 */
-CDCImplPrivate::ParsedMessage CDCImplPrivate::parseNextMessage(ustring& msgBuffer)
+void CDCImplPrivate::dispatchAsyncMessage(unsigned char* data, unsigned int length)
 {
-    ParsedMessage parsedMessage;
-    ustring parsedMsg;
+    AsyncListenerTable* table = asyncListeners.load();
+    if (table == NULL)
+        return;
 
-    // Bugfix of error in fw implementation
-    if (msgBuffer.length() > 0 && msgBuffer[0] == '>')
-        msgBuffer[0] = '<';
+    const std::vector<const AsyncSubscription*> noSubscriptions;
+    const std::vector<const AsyncSubscription*>& indexed = (length >= 4)? table->byPeripheral[data[2]] : noSubscriptions;
+    const std::vector<const AsyncSubscription*>& any = table->anyPeripheral;
+
+    int nodeAddress = (length >= 4)? (data[0] | (data[1] << 8)) : AsyncMsgFilter::ANY;
+    int command = (length >= 4)? (data[3] & 0x7F) : AsyncMsgFilter::ANY;
+
+    // merge of both lists by identifiers keeps order of adding
+    size_t indexedPos = 0;
+    size_t anyPos = 0;
+    while (indexedPos < indexed.size() || anyPos < any.size()) {
+        const AsyncSubscription* subscription = NULL;
+        if (anyPos == any.size()
+                || (indexedPos < indexed.size() && indexed[indexedPos]->id < any[anyPos]->id))
+            subscription = indexed[indexedPos++];
+        else
+            subscription = any[anyPos++];
+
+        const AsyncMsgFilter& filter = subscription->filter;
+        if (length < 4 && (filter.nodeAddress != AsyncMsgFilter::ANY || filter.command != AsyncMsgFilter::ANY))
+            continue;
+        if (filter.nodeAddress != AsyncMsgFilter::ANY && filter.nodeAddress != nodeAddress)
+            continue;
+        if (filter.command != AsyncMsgFilter::ANY && filter.command != command)
+            continue;
+
+        subscription->listener(data, length);
+    }
+}
 
-    ParseResult parseResult = msgParser->parseData(msgBuffer);
+void CDCImplPrivate::startCapture(const char* fileName)
+{
+    CDCCaptureWriter* writer = ant_new CDCCaptureWriter(fileName);
 
-    switch (parseResult.resultType) {
-    case PARSE_OK:
-        parsedMsg = msgBuffer.substr(0, parseResult.lastPosition + 1);
-        parsedMessage.message = parsedMsg;
-        break;
+    std::lock_guard<std::mutex> lck(csCapture);
+    delete captureWriter;
+    captureWriter = writer;
+}
 
-    case PARSE_NOT_COMPLETE:
-        parsedMessage.message = ustring(uchar_str(""));
-        break;
+void CDCImplPrivate::stopCapture(void)
+{
+    std::lock_guard<std::mutex> lck(csCapture);
+    delete captureWriter;
+    captureWriter = NULL;
+}
+
+void CDCImplPrivate::captureData(CaptureDirection direction, const unsigned char* data, size_t dlen)
+{
+    std::lock_guard<std::mutex> lck(csCapture);
+    if (captureWriter != NULL)
+        captureWriter->write(direction, data, dlen);
+}
+
+bool CDCImplPrivate::getReceptionStopped(void)
+{
+    std::lock_guard<std::mutex> lck(csReadingStopped);
+    bool tmpReadingStopped = receptionStopped;
+    return tmpReadingStopped;
+}
+
+void CDCImplPrivate::setReceptionStopped(bool value)
+{
+    {
+        std::lock_guard<std::mutex> lck(csReadingStopped);
+        receptionStopped = value;
+    }
+
+    // commands waiting for reconnection
+    std::lock_guard<std::mutex> lck(csTransport);
+    connectionCond.notify_all();
+}
+
+/* Sets last reception error according to parameters. */
+void CDCImplPrivate::setLastReceptionError(const std::string& descr)
+{
+    std::lock_guard<std::mutex> lck(csLastRecpError);
+    lastReceptionError = descr;
+}
+
+/* Clones last reception error. */
+std::string CDCImplPrivate::cloneLastReceptionError()
+{
+    std::lock_guard<std::mutex> lck(csLastRecpError);
+    std::string ret(lastReceptionError.c_str());
+    return ret;
+}
+
+/*
+* Process specified message. First of all, the message is parsed.
+* If the message is asynchronous message, then  registered listener(if exists)
+* is called. Response to command sent by sendDataAsync finishes the command.
+* Otherwise, last response is updated and "anew message" signal for main
+* thread is set.
+* @throw CDCReceiveException
+*/
+void CDCImplPrivate::processMessage(ParsedMessage& parsedMessage)
+{
+    metrics.receivedMessages.fetch_add(1, std::memory_order_relaxed);
 
-    case PARSE_BAD_FORMAT:
-        parsedMessage.message = ustring(uchar_str(""));
-        break;
+    if (parsedMessage.parseResult.msgType == MSG_ASYNC) {
+        // table of listeners cannot be freed until the epoch is even again,
+        // listeners changed by the dispatching thread itself are retired
+        dispatchThread = std::this_thread::get_id();
+        dispatchEpoch.fetch_add(1);
+        if (asyncListeners.load() != NULL) {
+            // data of "<DRn:data\r" are passed in place, terminated by NUL
+            // instead of the message end
+            FrameBytes& message = parsedMessage.message;
+            const size_t DR_DATA_POS = 5;
+            size_t userDataLen = message.length() - 1 - DR_DATA_POS;
+            message[message.length() - 1] = '\0';
+            try {
+                dispatchAsyncMessage(&message[DR_DATA_POS], static_cast<unsigned int>(userDataLen));
+            } catch (...) {
+                dispatchEpoch.fetch_add(1);
+                dispatchThread = std::thread::id();
+                throw;
+            }
+        }
+        dispatchEpoch.fetch_add(1);
+        dispatchThread = std::thread::id();
+
+        requestStatusRefresh();
+        return;
+    }
+
+    if (completePendingCommand(parsedMessage))
+        return;
+
+    if (collectBatchResponse(parsedMessage))
+        return;
+
+    // hands the message over to the waiting command without copying
+    responseSlot.post(std::move(parsedMessage));
+}
+
+/*
+* Extracts and processes all messages inside the specified buffer.
+* Messages are parsed at increasing offset and the processed bytes are
+* erased at once, so a burst of messages is not moved for each of them.
+* @throw CDCReading Exception
+*/
+void CDCImplPrivate::processAllMessages(FrameBytes& msgBuffer)
+{
+    size_t msgStart = 0;
+    try {
+        while (msgStart < msgBuffer.size()) {
+            ParsedMessage parsedMessage = parseNextMessage(msgBuffer, msgStart);
+            if (parsedMessage.parseResult.resultType == PARSE_NOT_COMPLETE)
+                break;
+
+            if (parsedMessage.parseResult.resultType == PARSE_BAD_FORMAT) {
+                // throw all bytes from the buffer up to next valid message
+                size_t nextMsgPos = findNextMessage(msgBuffer, msgStart);
+                metrics.badFrames.fetch_add(1, std::memory_order_relaxed);
+                metrics.discardedBytes.fetch_add(nextMsgPos - msgStart, std::memory_order_relaxed);
+                msgStart = nextMsgPos;
+
+                setLastReceptionError("Bad message format");
+            } else {
+                msgStart += parsedMessage.parseResult.lastPosition + 1;
+                processMessage(parsedMessage);
+            }
+        }
+    } catch (...) {
+        msgBuffer.erase(0, msgStart);
+        throw;
+    }
+
+    msgBuffer.erase(0, msgStart);
+}
+
+/*
+* Extracts message string from specified buffer and returns
+* it in the form of string. If the buffer does not contain
+* full message, empty string is returned.
+* @param msgStart position of the message in the buffer
+*/
+CDCImplPrivate::ParsedMessage CDCImplPrivate::parseNextMessage(FrameBytes& msgBuffer, size_t msgStart)
+{
+    ParsedMessage parsedMessage(frameAllocator);
+
+    // Bugfix of error in fw implementation
+    if (msgBuffer.length() > msgStart && msgBuffer[msgStart] == '>')
+        msgBuffer[msgStart] = '<';
+
+    ustring_view message(msgBuffer.data() + msgStart, msgBuffer.size() - msgStart);
+    ParseResult parseResult = msgParser->parseData(message, getExpectedResponse());
+
+    // message is copied into buffer from the pool
+    if (parseResult.resultType == PARSE_OK) {
+        if (parseResult.msgType == MSG_TR_INFO)
+            moduleInfoLength = parseResult.lastPosition + 1;
+
+        framePool.acquire(parsedMessage.message);
+        parsedMessage.pool = &framePool;
+        parsedMessage.message.assign(message.data(), parseResult.lastPosition + 1);
     }
 
     parsedMessage.parseResult = parseResult;
     return parsedMessage;
 }
 
+/*
+* Finds start of the next message after bad frame at specified position
+* of the buffer. Data of DR messages can contain 0x0D and '<', so each
+* candidate header is validated by the parser - it has to have correct
+* structure and length, or it has to be incomplete yet.
+* @return position of the next message, size of the buffer if there is none
+*/
+size_t CDCImplPrivate::findNextMessage(FrameBytes& msgBuffer, size_t badStart)
+{
+    ParseContext context = getExpectedResponse();
+    for (size_t pos = badStart + 1; pos < msgBuffer.size(); pos++) {
+        unsigned char header = msgBuffer[pos];
+        if (header != '<' && header != '>')
+            continue;
+
+        // Bugfix of error in fw implementation, as in parseNextMessage
+        msgBuffer[pos] = '<';
+        ustring_view candidate(msgBuffer.data() + pos, msgBuffer.size() - pos);
+        if (msgParser->parseData(candidate, context).resultType != PARSE_BAD_FORMAT)
+            return pos;
+        msgBuffer[pos] = header;
+    }
+
+    return msgBuffer.size();
+}
+
 /*
 * Construct command and returns it.
 * @return command of specified message type with data.
@@ -500,14 +1182,28 @@ CDCImplPrivate::Command CDCImplPrivate::constructCommand(MessageType msgType, us
 {
     //flog << "implObj->constructCommand - begin:\n";
 
-    Command cmd;
+    Command cmd(frameAllocator);
     cmd.msgType = msgType;
-    cmd.data = data;
+    cmd.data.assign(data.data(), data.size());
 
     //flog << "implObj->constructCommand - end\n" ;
     return cmd;
 }
 
+/*
+* Constructs command with data copied into buffer from the pool.
+*/
+CDCImplPrivate::Command CDCImplPrivate::constructCommand(MessageType msgType, const unsigned char* data,
+    unsigned int dlen)
+{
+    Command cmd(frameAllocator);
+    cmd.msgType = msgType;
+    framePool.acquire(cmd.data);
+    cmd.pool = &framePool;
+    cmd.data.assign(data, dlen);
+    return cmd;
+}
+
 /*
 * Bufferize specified command, so that it can be passed to COM-port.
 * @param cmd command to bufferize
@@ -515,7 +1211,24 @@ CDCImplPrivate::Command CDCImplPrivate::constructCommand(MessageType msgType, us
 */
 CDCImplPrivate::BuffCommand CDCImplPrivate::commandToBuffer(Command& cmd)
 {
-    ustring tmpStr(uchar_str(">"));
+    commandToBytes(cmd, transmitBytes);
+
+    // bytes are passed to COM-port directly from the reused buffer
+    BuffCommand buffCmd;
+    buffCmd.cmd = &transmitBytes[0];
+    buffCmd.len = static_cast<DWORD>(transmitBytes.size());
+
+    return buffCmd;
+}
+
+/*
+* Converts specified command to bytes, as they are passed to COM-port.
+* @param cmd command to convert
+* @param tmpStr bytes of the command, its buffer is reused
+*/
+void CDCImplPrivate::commandToBytes(Command& cmd, FrameBytes& tmpStr)
+{
+    tmpStr.assign(1, '>');
     if (cmd.msgType != MSG_TEST)
         tmpStr.append(uchar_str(messageHeaders[cmd.msgType].c_str()));
 
@@ -547,20 +1260,6 @@ CDCImplPrivate::BuffCommand CDCImplPrivate::commandToBuffer(Command& cmd)
     }
 
     tmpStr.append(1, 0x0D);
-
-    size_t sz = tmpStr.size();
-    if (m_transmitBufferLen < sz) { //reallocate
-        delete[] m_transmitBuffer;
-        m_transmitBuffer = ant_new unsigned char[sz];
-        m_transmitBufferLen = static_cast<DWORD>(sz);
-    }
-
-    BuffCommand buffCmd;
-    buffCmd.cmd = m_transmitBuffer;
-    tmpStr.copy(buffCmd.cmd, sz);
-    buffCmd.len = static_cast<DWORD>(sz);
-
-    return buffCmd;
 }
 
 /*
@@ -581,25 +1280,964 @@ CDCImplPrivate::BuffCommand CDCImplPrivate::commandToBuffer(Command& cmd)
 /*
 * Sends command, waits for response a checks the response.
 * @param cmd command to process.
+* @return received response
 * @throw CDCImplException if some error occurs during processing
 */
-void CDCImplPrivate::processCommand(Command& cmd)
+CDCImplPrivate::ParsedMessage CDCImplPrivate::processCommand(Command& cmd)
+{
+    ParsedMessage response;
+    CDCStatus status = tryProcessCommand(cmd, response);
+    if (!status)
+        throwError(status);
+    return response;
+}
+
+/*
+* Sends command, waits for response a checks the response. Errors
+* are only reported by returned status, so no message is formatted.
+* Commands of concurrent callers are processed one by one.
+* @param cmd command to process.
+* @param response received response
+* @return status of processing
+*/
+CDCStatus CDCImplPrivate::tryProcessCommand(Command& cmd, ParsedMessage& response)
 {
     if (getReceptionStopped())
-        THROW_EXCEPT(CDCSendException, "Reading is actually stopped")
+        return CDCStatus(CDCErrorCode::RECEPTION_STOPPED);
+
+    if (cmd.data.size() > UCHAR_MAX)
+        return CDCStatus(CDCErrorCode::DATA_TOO_LARGE);
+
+    std::lock_guard<std::mutex> lck(csCommand);
 
-    sendCommand(cmd);
-    //wait for response
-    waitForMyEvent(newMsgEvent, TM_WAIT_RESP);
+    CDCStatus status = beginSyncCommand();
+    if (!status)
+        return status;
+
+    status = tryProcessSyncCommand(cmd, response);
+
+    // queued asynchronous commands are sent after this one, the next
+    // synchronous command cannot begin meanwhile
+    endSyncCommand();
+    return status;
+}
 
-    if (lastResponse.parseResult.msgType != cmd.msgType) {
-        // TODO: Find some better way to solve upload/download duality
-        if (!((cmd.msgType == MSG_UPLOAD_DOWNLOAD)
-                && (lastResponse.parseResult.msgType == MSG_DOWNLOAD_DATA)
-                && ((cmd.data[0] & 0x80) == 0)))
+/*
+* Sends command and waits for its response, called with locked csCommand.
+* @param cmd command to process.
+* @param response received response
+* @return status of processing
+*/
+CDCStatus CDCImplPrivate::tryProcessSyncCommand(Command& cmd, ParsedMessage& response)
+{
+    for (;;) {
+        std::chrono::steady_clock::time_point sendTime = std::chrono::steady_clock::now();
+        unsigned int generation = 0;
+        CDCStatus status = trySendConnected(cmd, generation);
+
+        //wait for response
+        if (status)
+            status = waitForResponse(response);
+
+        // device was lost before or during processing
+        if (status.error() == CDCErrorCode::DEVICE_DISCONNECTED
+                || generation != getConnectionGeneration())
         {
-            THROW_EXCEPT(CDCReceiveException, "Response has bad type.");
+            if (waitForReplay())
+                continue;
+            return CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
         }
+
+        if (!status)
+            return status;
+
+        if (!isExpectedResponse(cmd.msgType, isDownload(cmd), response.parseResult.msgType))
+            return CDCStatus(CDCErrorCode::BAD_RESPONSE);
+
+        std::chrono::microseconds latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - sendTime);
+        metrics.responses.fetch_add(1, std::memory_order_relaxed);
+        metrics.responseLatency.fetch_add(latency.count(), std::memory_order_relaxed);
+        return status;
+    }
+}
+
+/*
+* Waits for response of sent synchronous command and takes it over.
+* @param response received response
+* @return status of waiting
+*/
+CDCStatus CDCImplPrivate::waitForResponse(ParsedMessage& response)
+{
+    switch (responseSlot.wait(response, options.responseTimeout)) {
+    case CDCCompletionSlot<ParsedMessage>::WAIT_OK:
+        return CDCStatus();
+    case CDCCompletionSlot<ParsedMessage>::WAIT_INTERRUPTED:
+        return CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+    default:
+        return CDCStatus(CDCErrorCode::RESPONSE_TIMEOUT);
+    }
+}
+
+/*
+* Checks, if response of specified type belongs to command of specified type.
+* @param cmdType type of the command
+* @param download the command is download, which is answered by data
+* @param responseType type of the response
+*/
+bool CDCImplPrivate::isExpectedResponse(MessageType cmdType, bool download, MessageType responseType)
+{
+    if (responseType == cmdType)
+        return true;
+
+    // TODO: Find some better way to solve upload/download duality
+    return download && responseType == MSG_DOWNLOAD_DATA;
+}
+
+bool CDCImplPrivate::isDownload(Command& cmd)
+{
+    return cmd.msgType == MSG_UPLOAD_DOWNLOAD && !cmd.data.empty() && (cmd.data[0] & 0x80) == 0;
+}
+
+/*
+* Returns response expected after specified command. Downloaded data
+* depend on the target - configuration of RFPGM and RF band is one byte,
+* HWP configuration and memory blocks are 32 bytes.
+*/
+ParseContext CDCImplPrivate::expectedResponseOf(Command& cmd)
+{
+    if (cmd.msgType == MSG_TR_INFO)
+        return ParseContext(MSG_TR_INFO, moduleInfoLength.load());
+
+    if (cmd.msgType != MSG_UPLOAD_DOWNLOAD)
+        return ParseContext();
+
+    if (!isDownload(cmd))
+        return ParseContext(MSG_UPLOAD_DOWNLOAD);
+
+    // "<PM:" and 0x0D
+    const unsigned int PM_FRAME_SIZE = 5;
+    switch (cmd.data[0]) {
+    case 0x01:
+    case 0x02:
+        return ParseContext(MSG_DOWNLOAD_DATA, PM_FRAME_SIZE + 1);
+    case 0x00:
+    case 0x05:
+    case 0x06:
+    case 0x07:
+        return ParseContext(MSG_DOWNLOAD_DATA, PM_FRAME_SIZE + 32);
+    default:
+        return ParseContext(MSG_DOWNLOAD_DATA);
+    }
+}
+
+void CDCImplPrivate::setExpectedResponse(const ParseContext& context)
+{
+    std::lock_guard<std::mutex> lck(csExpectedResponse);
+    expectedResponse = context;
+}
+
+ParseContext CDCImplPrivate::getExpectedResponse(void)
+{
+    std::lock_guard<std::mutex> lck(csExpectedResponse);
+    return expectedResponse;
+}
+
+/*
+* Marks synchronous command, so that no queued command is sent before its
+* response. Waits, until queued command being written is written completely.
+* @return status, SEND_TIMEOUT if the queued command is not written in time
+*/
+CDCStatus CDCImplPrivate::beginSyncCommand(void)
+{
+    DWORD sendTimeout = TM_SEND_MSG;
+    std::unique_lock<std::mutex> lck(csPendingCommands);
+    auto written = [this] { return !pendingSent || pendingWritten == pendingCommands.front().bytes.size(); };
+    if (!pendingCond.wait_for(lck, std::chrono::milliseconds(sendTimeout), written))
+        return CDCStatus(CDCErrorCode::SEND_TIMEOUT);
+
+    syncCommandActive = true;
+    return CDCStatus();
+}
+
+void CDCImplPrivate::endSyncCommand(void)
+{
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        syncCommandActive = false;
+    }
+    startPendingCommand();
+}
+
+/*
+* Queues command sent by one of *Async functions and sends it, if no other
+* command is being processed.
+* @param cmd command
+* @param handler handler of the response
+*/
+void CDCImplPrivate::queueCommand(Command& cmd, PendingHandlerF handler)
+{
+    ParsedMessage noResponse;
+    if (getReceptionStopped()) {
+        handler(CDCStatus(CDCErrorCode::RECEPTION_STOPPED), noResponse);
+        return;
+    }
+
+    if (cmd.data.size() > UCHAR_MAX) {
+        handler(CDCStatus(CDCErrorCode::DATA_TOO_LARGE), noResponse);
+        return;
+    }
+
+    PendingCommand pendingCmd;
+    pendingCmd.bytes = FrameBytes(frameAllocator);
+    commandToBytes(cmd, pendingCmd.bytes);
+    pendingCmd.msgType = cmd.msgType;
+    pendingCmd.download = isDownload(cmd);
+    pendingCmd.expectedResponse = expectedResponseOf(cmd);
+    pendingCmd.handler = handler;
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        pendingCommands.push_back(std::move(pendingCmd));
+    }
+    startPendingCommand();
+}
+
+/*
+* Removes the first queued command. Must be called with locked
+* csPendingCommands.
+* @return the removed command
+*/
+CDCImplPrivate::PendingCommand CDCImplPrivate::popPendingCommand(void)
+{
+    PendingCommand pendingCmd = std::move(pendingCommands.front());
+    pendingCommands.pop_front();
+    pendingSent = false;
+    pendingWritten = 0;
+    pendingCond.notify_all();
+    return pendingCmd;
+}
+
+/*
+* Calls handler of finished command with specified error.
+*/
+void CDCImplPrivate::finishPendingCommand(PendingCommand& pendingCmd, const CDCStatus& status)
+{
+    ParsedMessage noResponse;
+    pendingCmd.handler(status, noResponse);
+}
+
+/*
+* Finishes the first queued command by specified response, if the command
+* has been written and waits for the response. As no other command is sent
+* meanwhile, the next response belongs to it.
+* @return true if the response was consumed by the command
+*/
+bool CDCImplPrivate::completePendingCommand(ParsedMessage& response)
+{
+    PendingCommand pendingCmd;
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        if (!pendingSent || pendingWritten < pendingCommands.front().bytes.size())
+            return false;
+        pendingCmd = popPendingCommand();
+    }
+
+    if (isExpectedResponse(pendingCmd.msgType, pendingCmd.download, response.parseResult.msgType))
+        pendingCmd.handler(CDCStatus(), response);
+    else
+        finishPendingCommand(pendingCmd, CDCStatus(CDCErrorCode::BAD_RESPONSE));
+
+    startPendingCommand();
+    return true;
+}
+
+/*
+* Finishes the first queued command with RESPONSE_TIMEOUT, if its deadline
+* has passed, and sends the next one.
+*/
+void CDCImplPrivate::processPendingTimeout(void)
+{
+    PendingCommand pendingCmd;
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        if (!pendingSent || std::chrono::steady_clock::now() < pendingCommands.front().deadline)
+            return;
+        pendingCmd = popPendingCommand();
+    }
+
+    finishPendingCommand(pendingCmd, CDCStatus(CDCErrorCode::RESPONSE_TIMEOUT));
+    startPendingCommand();
+}
+
+/*
+* Finishes all queued commands with specified error.
+*/
+void CDCImplPrivate::failPendingCommands(const CDCStatus& status)
+{
+    PendingQueue failed(frameAllocator);
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        failed.swap(pendingCommands);
+        pendingSent = false;
+        pendingWritten = 0;
+        pendingCond.notify_all();
+    }
+
+    for (PendingCommand& pendingCmd : failed)
+        finishPendingCommand(pendingCmd, status);
+}
+
+bool CDCImplPrivate::isWritePending(void)
+{
+    std::lock_guard<std::mutex> lck(csPendingCommands);
+    return pendingSent && pendingWritten < pendingCommands.front().bytes.size();
+}
+
+/*
+* Returns time to the deadline of the first queued command.
+* @return time in milliseconds, rounded up, -1 if no command is sent
+*/
+int CDCImplPrivate::getTimerTimeout(void)
+{
+    std::lock_guard<std::mutex> lck(csPendingCommands);
+    if (!pendingSent)
+        return -1;
+
+    std::chrono::steady_clock::duration remaining = pendingCommands.front().deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero())
+        return 0;
+
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+}
+
+/*
+* Sends command, if the device is connected. The transport is not
+* changed by the reading thread during sending.
+* @param cmd command to send
+* @param generation connection generation, in which the command is sent
+* @return status of sending
+*/
+CDCStatus CDCImplPrivate::trySendConnected(Command& cmd, unsigned int& generation)
+{
+    std::lock_guard<std::mutex> lck(csTransport);
+    generation = connectionGeneration;
+    if (!connected)
+        return CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+
+    return trySendCommand(cmd);
+}
+
+/*
+* Waits for reconnection of the device, if pending commands are replayed.
+* @return true if the device was reconnected and the command can be sent again
+*/
+bool CDCImplPrivate::waitForReplay(void)
+{
+    ReconnectOptions reconnectOptions = getReconnect();
+    if (!reconnectOptions.enabled || reconnectOptions.pendingCommands != PendingCommandPolicy::REPLAY)
+        return false;
+
+    std::unique_lock<std::mutex> lck(csTransport);
+    auto reconnected = [this] { return connected || getReceptionStopped(); };
+    if (reconnectOptions.timeout == 0)
+        connectionCond.wait(lck, reconnected);
+    else
+        connectionCond.wait_for(lck, std::chrono::milliseconds(reconnectOptions.timeout), reconnected);
+
+    return connected && !getReceptionStopped();
+}
+
+unsigned int CDCImplPrivate::getConnectionGeneration(void)
+{
+    std::lock_guard<std::mutex> lck(csTransport);
+    return connectionGeneration;
+}
+
+/*
+* Closes port of lost device. Command waiting for response is woken up
+* and it finds out the loss by changed connection generation.
+*/
+void CDCImplPrivate::disconnectTransport(void)
+{
+    {
+        std::lock_guard<std::mutex> lck(csTransport);
+        closeTransport();
+        connected = false;
+        connectionGeneration++;
+    }
+    responseSlot.interrupt();
+
+    notifyConnection(false);
+}
+
+/*
+* Sets transport of reopened port. Cached information about the device
+* is discarded, because another device could have been connected.
+* @param newTransport transport of reopened port
+*/
+void CDCImplPrivate::connectTransport(CDCTransport* newTransport)
+{
+    invalidateIdentification(true, true);
+    cachedStatus = 0;
+
+    {
+        std::lock_guard<std::mutex> lck(csTransport);
+        transport = newTransport;
+        portHandle = transport->getHandle();
+        connected = true;
+        connectionCond.notify_all();
+    }
+
+    notifyConnection(true);
+}
+
+void CDCImplPrivate::setReconnect(const ReconnectOptions& options)
+{
+    std::lock_guard<std::mutex> lck(csReconnect);
+    reconnect = options;
+}
+
+ReconnectOptions CDCImplPrivate::getReconnect(void)
+{
+    std::lock_guard<std::mutex> lck(csReconnect);
+    return reconnect;
+}
+
+void CDCImplPrivate::setConnectionListener(ConnectionListenerF listener)
+{
+    std::lock_guard<std::mutex> lck(csConnectionListener);
+    connectionListener = listener;
+}
+
+void CDCImplPrivate::notifyConnection(bool value)
+{
+    std::lock_guard<std::mutex> lck(csConnectionListener);
+    if (connectionListener)
+        connectionListener(value);
+}
+
+/*
+* Sends DS command. If pacing is enabled, command refused by BUSY response
+* is held and sent again, as soon as SPI status reports ready module.
+* While the module is not ready, the status is queried with exponential
+* backoff. Paced commands of concurrent callers are sent in order.
+* @param cmd DS command
+* @return DS response or error
+*/
+CDCResult<DSResponse> CDCImplPrivate::processDataSend(Command& cmd)
+{
+    PacingOptions pacingOptions = getPacing();
+
+    ParsedMessage response;
+    if (!pacingOptions.enabled) {
+        CDCStatus status = tryProcessCommand(cmd, response);
+        if (!status)
+            return status;
+        requestStatusRefresh();
+        return msgParser->getParsedDSResponse(response.message);
+    }
+
+    std::lock_guard<std::mutex> lck(csDataSend);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(pacingOptions.timeout);
+    std::chrono::microseconds backoff(pacingOptions.initialBackoff);
+    Command statusCmd = constructCommand(MSG_SPI_STAT, uchar_str(""));
+
+    for (bool firstAttempt = true; ; firstAttempt = false) {
+        CDCStatus status = tryProcessCommand(cmd, response);
+        if (!status)
+            return status;
+
+        DSResponse dsResponse = msgParser->getParsedDSResponse(response.message);
+        if (dsResponse != BUSY) {
+            requestStatusRefresh();
+            return dsResponse;
+        }
+
+        // the first refusal is resent as soon as the module reports ready,
+        // repeated refusals are delayed
+        for (bool delay = !firstAttempt; ; delay = true) {
+            if (delay) {
+                Clock::time_point now = Clock::now();
+                if (now >= deadline)
+                    return BUSY;
+
+                std::chrono::microseconds remaining
+                    = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+                std::this_thread::sleep_for(std::min(backoff, remaining));
+                backoff = std::min(backoff * 2, std::chrono::microseconds(pacingOptions.maxBackoff));
+            }
+
+            if (Clock::now() >= deadline)
+                return BUSY;
+
+            status = tryProcessCommand(statusCmd, response);
+            if (!status)
+                return status;
+
+            if (isReadyStatus(parseStatusResponse(response)))
+                break;
+        }
+    }
+}
+
+/*
+* Sends DS commands of specified frames as one batch. The commands are
+* joined in the transmit buffer and written at once, the reading thread
+* collects their responses and wakes up this thread by the last one.
+* The commands are not paced and not replayed after reconnection.
+* @param frames data of DS commands
+* @param results result of each frame
+*/
+void CDCImplPrivate::processDataSendBatch(const std::vector<ustring>& frames,
+        std::vector<CDCResult<DSResponse>>& results)
+{
+    if (getReceptionStopped()) {
+        std::fill(results.begin(), results.end(), CDCStatus(CDCErrorCode::RECEPTION_STOPPED));
+        return;
+    }
+
+    std::vector<size_t> sentFrames;
+    sentFrames.reserve(frames.size());
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (frames[i].size() > UCHAR_MAX)
+            results[i] = CDCStatus(CDCErrorCode::DATA_TOO_LARGE);
+        else
+            sentFrames.push_back(i);
+    }
+
+    if (sentFrames.empty())
+        return;
+
+    std::lock_guard<std::mutex> lck(csCommand);
+
+    CDCStatus status = beginSyncCommand();
+    if (!status) {
+        for (size_t frameIndex : sentFrames)
+            results[frameIndex] = status;
+        return;
+    }
+
+    // transmit buffer is used by commands under csCommand only
+    Command cmd(frameAllocator);
+    cmd.msgType = MSG_DATA_SEND;
+    FrameBytes frameBytes(frameAllocator);
+    transmitBytes.clear();
+    for (size_t frameIndex : sentFrames) {
+        cmd.data.assign(frames[frameIndex].data(), frames[frameIndex].size());
+        commandToBytes(cmd, frameBytes);
+        transmitBytes.append(frameBytes);
+    }
+
+    {
+        std::lock_guard<std::mutex> batchLck(csBatch);
+        batchResponses.clear();
+        batchResponses.reserve(sentFrames.size());
+        batchRemaining = sentFrames.size();
+    }
+
+    unsigned int generation = 0;
+    {
+        std::lock_guard<std::mutex> transportLck(csTransport);
+        generation = connectionGeneration;
+        if (!connected) {
+            status = CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+        } else {
+            // response to previous timeouted command
+            responseSlot.reset();
+            setExpectedResponse(ParseContext());
+            status = trySendBytes(transmitBytes.data(), static_cast<unsigned int>(transmitBytes.size()));
+        }
+    }
+
+    // the last response is passed by the slot, the others are collected
+    if (status) {
+        ParsedMessage lastResponse;
+        // saturated, long batch with large timeout must not wrap around
+        unsigned long long batchTimeout = static_cast<unsigned long long>(options.responseTimeout) * sentFrames.size();
+        unsigned int timeout = static_cast<unsigned int>(std::min<unsigned long long>(batchTimeout, UINT_MAX));
+        switch (responseSlot.wait(lastResponse, timeout)) {
+        case CDCCompletionSlot<ParsedMessage>::WAIT_OK:
+            break;
+        case CDCCompletionSlot<ParsedMessage>::WAIT_INTERRUPTED:
+            status = CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+            break;
+        default:
+            status = CDCStatus(CDCErrorCode::RESPONSE_TIMEOUT);
+            break;
+        }
+
+        if (generation != getConnectionGeneration())
+            status = CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+    }
+
+    size_t received = 0;
+    {
+        std::lock_guard<std::mutex> batchLck(csBatch);
+        batchRemaining = 0;
+        received = batchResponses.size();
+        for (size_t i = 0; i < sentFrames.size(); i++)
+            results[sentFrames[i]] = (i < received)? batchResponses[i] : status;
+    }
+
+    // queued asynchronous commands are sent after the batch
+    endSyncCommand();
+
+    if (received > 0)
+        requestStatusRefresh();
+}
+
+/*
+* Collects response to command of the batch being sent. All responses are
+* stored, the last one is passed to responseSlot to wake up the sender.
+* @return true if the response was consumed by the batch
+*/
+bool CDCImplPrivate::collectBatchResponse(ParsedMessage& response)
+{
+    std::lock_guard<std::mutex> lck(csBatch);
+    if (batchRemaining == 0)
+        return false;
+
+    CDCResult<DSResponse> result = CDCStatus(CDCErrorCode::BAD_RESPONSE);
+    if (response.parseResult.msgType == MSG_DATA_SEND) {
+        try {
+            result = msgParser->getParsedDSResponse(response.message);
+        } catch (...) {
+            // stays BAD_RESPONSE
+        }
+    }
+    batchResponses.push_back(result);
+
+    batchRemaining--;
+    return batchRemaining > 0;
+}
+
+/*
+* Indicates, whether the module is able to accept DS command.
+*/
+bool CDCImplPrivate::isReadyStatus(const SPIStatus& spiStatus)
+{
+    if (spiStatus.isDataReady)
+        return false;
+
+    return spiStatus.SPI_MODE == READY_COMM || spiStatus.SPI_MODE == SLOW_MODE;
+}
+
+void CDCImplPrivate::setPacing(const PacingOptions& options)
+{
+    std::lock_guard<std::mutex> lck(csPacing);
+    pacing = options;
+}
+
+PacingOptions CDCImplPrivate::getPacing(void)
+{
+    std::lock_guard<std::mutex> lck(csPacing);
+    return pacing;
+}
+
+void CDCImplPrivate::setBusyPoll(const BusyPollOptions& options)
+{
+    busyPollTime = options.enabled? options.spinTime : 0;
+}
+
+CDCMetrics CDCImplPrivate::getMetrics(void)
+{
+    CDCMetrics result;
+    result.receivedMessages = metrics.receivedMessages.load(std::memory_order_relaxed);
+    result.blockingReceptions = metrics.blockingReceptions.load(std::memory_order_relaxed);
+    result.spinReceptions = metrics.spinReceptions.load(std::memory_order_relaxed);
+    result.spinTime = metrics.spinTime.load(std::memory_order_relaxed);
+    result.responses = metrics.responses.load(std::memory_order_relaxed);
+    result.responseLatency = metrics.responseLatency.load(std::memory_order_relaxed);
+    result.poolMisses = framePool.getMisses();
+    result.badFrames = metrics.badFrames.load(std::memory_order_relaxed);
+    result.discardedBytes = metrics.discardedBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+/*
+* Returns USB device info, which is received from the device only once
+* until the identification is invalidated.
+* @throw CDCImplException if some error occurs during processing
+*/
+USBDeviceInfo CDCImplPrivate::getUSBDeviceInfo(void)
+{
+    unsigned int generation = 0;
+    {
+        std::lock_guard<std::mutex> lck(csIdentification);
+        if (deviceInfoValid)
+            return deviceInfo;
+        generation = identificationGeneration;
+    }
+
+    Command cmd = constructCommand(MSG_USB_INFO, uchar_str(""));
+    ParsedMessage response = processCommand(cmd);
+
+    USBDeviceInfo devInfo;
+    msgParser->getParsedDeviceInfo(response.message, devInfo);
+
+    // info received before reset of the device is not cached
+    std::lock_guard<std::mutex> lck(csIdentification);
+    if (generation == identificationGeneration) {
+        deviceInfo = devInfo;
+        deviceInfoValid = true;
+    }
+    return devInfo;
+}
+
+/*
+* Returns TR module info, which is received from the device only once
+* until the identification is invalidated.
+* @throw CDCImplException if some error occurs during processing
+*/
+ModuleInfo CDCImplPrivate::getTRModuleInfo(void)
+{
+    unsigned int generation = 0;
+    {
+        std::lock_guard<std::mutex> lck(csIdentification);
+        if (moduleInfoValid)
+            return moduleInfo;
+        generation = identificationGeneration;
+    }
+
+    Command cmd = constructCommand(MSG_TR_INFO, uchar_str(""));
+    ParsedMessage response = processCommand(cmd);
+
+    ModuleInfo modInfo;
+    if (!msgParser->getParsedModuleInfo(response.message, modInfo))
+        THROW_EXCEPT(CDCReceiveException, "TR module identification data are corrupted");
+
+    // info received before reset of the module is not cached
+    std::lock_guard<std::mutex> lck(csIdentification);
+    if (generation == identificationGeneration) {
+        moduleInfo = modInfo;
+        moduleInfoValid = true;
+    }
+    return modInfo;
+}
+
+/*
+* Invalidates cached identification.
+* @param device invalidate USB device info
+* @param module invalidate TR module info
+*/
+void CDCImplPrivate::invalidateIdentification(bool device, bool module)
+{
+    std::lock_guard<std::mutex> lck(csIdentification);
+    identificationGeneration++;
+    if (device)
+        deviceInfoValid = false;
+    if (module) {
+        moduleInfoValid = false;
+        // another module can send identification of other length
+        moduleInfoLength = 0;
+    }
+}
+
+/*
+* Encodes SPI status into single value: bit 31 - status is valid,
+* bit 8 - DATA_READY is used, bits 0-7 - SPI mode or DATA_READY.
+*/
+uint32_t CDCImplPrivate::encodeStatus(const SPIStatus& spiStatus)
+{
+    uint32_t encodedStatus = 0x80000000;
+    if (spiStatus.isDataReady)
+        encodedStatus |= 0x100 | (spiStatus.DATA_READY & 0xFF);
+    else
+        encodedStatus |= spiStatus.SPI_MODE & 0xFF;
+    return encodedStatus;
+}
+
+SPIStatus CDCImplPrivate::decodeStatus(uint32_t encodedStatus)
+{
+    SPIStatus spiStatus;
+    spiStatus.isDataReady = (encodedStatus & 0x100) != 0;
+    if (spiStatus.isDataReady)
+        spiStatus.DATA_READY = encodedStatus & 0xFF;
+    else
+        spiStatus.SPI_MODE = static_cast<SPIModes>(encodedStatus & 0xFF);
+    return spiStatus;
+}
+
+/*
+* Parses S response and updates cached status.
+* @param response response to S command
+* @return parsed SPI status
+*/
+SPIStatus CDCImplPrivate::parseStatusResponse(ParsedMessage& response)
+{
+    SPIStatus spiStatus = msgParser->getParsedSPIStatus(response.message);
+    updateCachedStatus(spiStatus);
+    return spiStatus;
+}
+
+/*
+* Updates cached status and notifies registered listener, if the status
+* has changed. The listener is not notified about the first status.
+*/
+void CDCImplPrivate::updateCachedStatus(const SPIStatus& spiStatus)
+{
+    uint32_t encodedStatus = encodeStatus(spiStatus);
+    uint32_t oldStatus = cachedStatus.exchange(encodedStatus, std::memory_order_acq_rel);
+    if (oldStatus == encodedStatus || oldStatus == 0)
+        return;
+
+    // the listener can register another one
+    SPIStatusListenerF listener;
+    {
+        std::lock_guard<std::mutex> lck(csStatusListener);
+        listener = statusListener;
+    }
+    if (listener)
+        listener(decodeStatus(oldStatus), spiStatus);
+}
+
+void CDCImplPrivate::setStatusListener(SPIStatusListenerF listener)
+{
+    std::lock_guard<std::mutex> lck(csStatusListener);
+    statusListener = listener;
+}
+
+/*
+* Starts thread refreshing cached status.
+* @param interval interval of refreshing in milliseconds, 0 for none
+* @param onTraffic refresh after DS responses and DR messages
+*/
+void CDCImplPrivate::startStatusMonitor(unsigned int interval, bool onTraffic)
+{
+    stopStatusMonitor();
+
+    CDCStatus threadStatus;
+    {
+        std::lock_guard<std::mutex> lck(csStatusMonitor);
+        statusInterval = interval;
+        refreshOnTraffic = onTraffic;
+        statusRefreshRequested = true;
+        statusMonitorRunning = true;
+        statusMonitorHandle = std::thread(&CDCImplPrivate::statusMonitorThread, this);
+        threadStatus = applyThreadOptions(statusMonitorHandle, options.monitorThread);
+    }
+
+    if (!threadStatus) {
+        stopStatusMonitor();
+        THROW_EXCEPT(CDCImplException, "Setting of monitor thread failed: " << threadStatus.message());
+    }
+}
+
+void CDCImplPrivate::stopStatusMonitor(void)
+{
+    {
+        std::lock_guard<std::mutex> lck(csStatusMonitor);
+        statusMonitorRunning = false;
+        refreshOnTraffic = false;
+    }
+    statusMonitorCond.notify_one();
+
+    if (statusMonitorHandle.joinable())
+        statusMonitorHandle.join();
+}
+
+/*
+* Function of monitor thread. Sends S command after each interval and
+* on each refresh request. Failed commands are ignored, the cached status
+* is only kept until the next successful refresh.
+*/
+void CDCImplPrivate::statusMonitorThread(void)
+{
+    Command cmd = constructCommand(MSG_SPI_STAT, uchar_str(""));
+    ParsedMessage response;
+
+    std::unique_lock<std::mutex> lck(csStatusMonitor);
+    while (statusMonitorRunning) {
+        if (!statusRefreshRequested) {
+            auto refreshCond = [this] { return !statusMonitorRunning || statusRefreshRequested; };
+            if (statusInterval == 0)
+                statusMonitorCond.wait(lck, refreshCond);
+            else
+                statusMonitorCond.wait_for(lck, std::chrono::milliseconds(statusInterval), refreshCond);
+
+            if (!statusMonitorRunning)
+                break;
+        }
+        statusRefreshRequested = false;
+
+        lck.unlock();
+        try {
+            if (tryProcessCommand(cmd, response))
+                parseStatusResponse(response);
+        } catch (...) {
+            // parsing or listener error must not stop the monitor
+        }
+        lck.lock();
+    }
+}
+
+/*
+* Requests refreshing of cached status. Called after traffic, which can
+* change the status. Multiple requests are merged into one refresh, only
+* the first one wakes up the monitor, so that dispatch of DR messages does
+* not lock the monitor each time.
+*/
+void CDCImplPrivate::requestStatusRefresh(void)
+{
+    if (!refreshOnTraffic.load(std::memory_order_relaxed))
+        return;
+
+    if (statusRefreshRequested.exchange(true))
+        return;
+
+    // the monitor is either before checking the request, or waiting
+    {
+        std::lock_guard<std::mutex> lck(csStatusMonitor);
+    }
+    statusMonitorCond.notify_one();
+}
+
+/*
+* Sends command stored in buffer to COM port.
+* @param cmd command to send to COM-port.
+* @throw CDCSendException if sending fails
+*/
+void CDCImplPrivate::sendCommand(Command& cmd)
+{
+    CDCStatus status = trySendCommand(cmd);
+    if (!status)
+        throwError(status);
+}
+
+/*
+* Blocks, until specified event is not in signaling state.
+* @throw CDCReceiveException if waiting fails or timeouts
+*/
+void CDCImplPrivate::waitForMyEvent(HANDLE evnt, DWORD timeout)
+{
+    CDCStatus status = tryWaitForMyEvent(evnt, timeout);
+    if (!status)
+        throwError(status);
+}
+
+/*
+* Throws exception corresponding to specified failed status.
+*/
+void CDCImplPrivate::throwError(const CDCStatus& status)
+{
+    switch (status.error()) {
+    case CDCErrorCode::RECEPTION_STOPPED:
+    case CDCErrorCode::INVALID_ARGUMENT:
+    case CDCErrorCode::DATA_TOO_LARGE:
+    case CDCErrorCode::SEND_TIMEOUT:
+    case CDCErrorCode::SEND_FAILED:
+        THROW_EXCEPT(CDCSendException, status.message());
+
+    case CDCErrorCode::RESPONSE_TIMEOUT:
+    case CDCErrorCode::RECEIVE_FAILED:
+    case CDCErrorCode::BAD_RESPONSE:
+    case CDCErrorCode::DEVICE_DISCONNECTED:
+        THROW_EXCEPT(CDCReceiveException, status.message());
+
+    default:
+        THROW_EXCEPT(CDCImplException, status.message());
     }
 }
 
@@ -26,17 +26,12 @@ void CDCImplException::createDescription()
 }
 
 CDCImplException::CDCImplException(const char* cause)
+	:identity("CDCImplException"), cause(cause)
 {
-	this->identity = "CDCImplException";
-	this->cause = cause;
-	createDescription();
 }
 
 CDCImplException::~CDCImplException() throw()
 {
-	identity.clear();
-	cause.clear();
-	descr.clear();
 }
 
 /*
@@ -52,5 +47,8 @@ const char* CDCImplException::what() const throw()
  */
 const char* CDCImplException::getDescr()
 {
+	// formatted lazily - most of exceptions are only caught
+	if (descr.empty())
+		createDescription();
 	return descr.c_str();
 }
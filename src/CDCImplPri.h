@@ -22,9 +22,21 @@
 #include <windows.h>
 #endif
 #include <CDCMessageParser.h>
+#include <CDCCapture.h>
+#include <CDCTransport.h>
+#include <CDCResult.h>
+#include <CDCImpl.h>
+#include "CDCBufferPool.h"
+#include "CDCCompletionSlot.h"
 #include <map>
+#include <vector>
+#include <deque>
+#include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
 #include <string>
 
 #ifdef WIN32
@@ -33,7 +45,7 @@ static const DWORD scond = 1000;
 #else
 typedef unsigned long DWORD;
 typedef int HANDLE;
-static const DWORD scond = 1;
+static const DWORD scond = 1000;
 typedef void* LPVOID;
 #endif
 
@@ -43,13 +55,55 @@ typedef void* LPVOID;
 class CDCImplPrivate {
 public:
     CDCImplPrivate();
-    CDCImplPrivate(const char* commPort);
+    CDCImplPrivate(const char* commPort, const CDCImplOptions& options = CDCImplOptions());
+    CDCImplPrivate(CDCTransport* transport, const CDCImplOptions& options = CDCImplOptions());
     ~CDCImplPrivate();
 
-    /* Command, which will be sent to COM-port. */
+    /*
+    * Creates instance in memory of specified resource, NULL stands for
+    * the default resource. The instance is freed by destroy.
+    */
+    template <typename... Args>
+    static CDCImplPrivate* create(std::pmr::memory_resource* resource, Args&&... args);
+    static void destroy(CDCImplPrivate* implObj);
+
+    /*
+    * Command, which will be sent to COM-port. Buffer of data acquired from
+    * the pool is returned to it by destruction.
+    */
     struct Command {
         MessageType msgType;
-        ustring data;
+        FrameBytes data;
+        CDCBufferPool* pool;
+
+        Command()
+            :msgType(MSG_ERROR), pool(NULL) {}
+
+        explicit Command(const CDCAllocator<unsigned char>& allocator)
+            :msgType(MSG_ERROR), data(allocator), pool(NULL) {}
+
+        Command(Command&& other) noexcept
+            :msgType(other.msgType), data(std::move(other.data)), pool(other.pool)
+        {
+            other.pool = NULL;
+        }
+
+        Command& operator=(Command&& other) noexcept
+        {
+            if (pool != NULL)
+                pool->release(data);
+            msgType = other.msgType;
+            data = std::move(other.data);
+            pool = other.pool;
+            other.pool = NULL;
+            return *this;
+        }
+
+        ~Command()
+        {
+            if (pool != NULL)
+                pool->release(data);
+        }
     };
 
     /* Bufferized command for passing to COM-port. */
@@ -58,10 +112,53 @@ public:
         DWORD len;
     };
 
-    /* Info about parsed data. */
+    /*
+    * Info about parsed data. Buffer of the message acquired from the pool
+    * is returned to it by destruction.
+    */
     struct ParsedMessage {
-        ustring message;
+        FrameBytes message;
         ParseResult parseResult;
+        CDCBufferPool* pool;
+
+        ParsedMessage()
+            :pool(NULL)
+        {
+            parseResult.msgType = MSG_ERROR;
+            parseResult.resultType = PARSE_NOT_COMPLETE;
+            parseResult.lastPosition = 0;
+        }
+
+        explicit ParsedMessage(const CDCAllocator<unsigned char>& allocator)
+            :message(allocator), pool(NULL)
+        {
+            parseResult.msgType = MSG_ERROR;
+            parseResult.resultType = PARSE_NOT_COMPLETE;
+            parseResult.lastPosition = 0;
+        }
+
+        ParsedMessage(ParsedMessage&& other) noexcept
+            :message(std::move(other.message)), parseResult(other.parseResult), pool(other.pool)
+        {
+            other.pool = NULL;
+        }
+
+        ParsedMessage& operator=(ParsedMessage&& other) noexcept
+        {
+            if (pool != NULL)
+                pool->release(message);
+            message = std::move(other.message);
+            parseResult = other.parseResult;
+            pool = other.pool;
+            other.pool = NULL;
+            return *this;
+        }
+
+        ~ParsedMessage()
+        {
+            if (pool != NULL)
+                pool->release(message);
+        }
     };
 
 
@@ -75,18 +172,22 @@ public:
     /* Sending message to COM-port. */
     static const DWORD TM_SEND_MSG = 5 * scond;
 
-    /* Waiting for a response. */
+    /* Waiting for a response, default of options. */
     static const DWORD TM_WAIT_RESP = 5 * scond;
 
+    /* Options of the instance. */
+    CDCImplOptions options;
+
     HANDLE portHandle;		// handle to COM-port
     std::string m_commPort;
 
-    std::thread readMsgHandle;
+    /* Transport to USB device, always NULL on Windows. */
+    CDCTransport* transport;
 
-    /*
-    * Signal for main thread, that a message-respond was read from COM-port.
-    */
-    HANDLE newMsgEvent;
+    /* Transport was opened by the instance from port name. */
+    bool transportOwned;
+
+    std::thread readMsgHandle;
 
     /* Signal for main thread, that read thread has started. */
     HANDLE readStartEvent;
@@ -94,6 +195,9 @@ public:
     /* Signal for read thread to cancel. */
     HANDLE readEndEvent;
 
+    /* Signal for read thread to update its timeout and write interest. */
+    HANDLE readWakeEvent;
+
     HANDLE readEndResponse;
 
     /* Mapping from message types to response headers. */
@@ -103,20 +207,254 @@ public:
     CDCMessageParser* msgParser;
 
     /*
-    * Last received parsed response from COM-port.
-    * Not asynchronous message.
+    * Last received parsed response from COM-port, moved by the reading
+    * thread to the thread waiting for it. Not asynchronous message.
     */
-    ParsedMessage lastResponse;
+    CDCCompletionSlot<ParsedMessage> responseSlot;
+
+    /* Listener of asynchronous messages with its filter. */
+    struct AsyncSubscription {
+        unsigned int id;
+        AsyncMsgFilter filter;
+        AsyncMsgListenerF listener;
+    };
+
+    /*
+    * Immutable table of listeners of asynchronous messages. On each change,
+    * new table is created and swapped, so dispatching needs no lock.
+    * Listeners are indexed by PNUM, both lists are in order of adding.
+    */
+    struct AsyncListenerTable {
+        std::vector<AsyncSubscription> subscriptions;
+        std::vector<const AsyncSubscription*> byPeripheral[256];
+        std::vector<const AsyncSubscription*> anyPeripheral;
+        void buildIndex(void);
+    };
+
+    /* Identifier of listener registered by registerAsyncMsgListener. */
+    static const unsigned int LEGACY_LISTENER_ID = 0;
+
+    std::atomic<AsyncListenerTable*> asyncListeners;
+    unsigned int nextListenerId;
+
+    /*
+    * Incremented by the reading thread before and after dispatching,
+    * odd value means, that a table is in use.
+    */
+    std::atomic<unsigned long long> dispatchEpoch;
+
+    /*
+    * Thread dispatching asynchronous message - the reading thread, or the
+    * thread calling onReadable in event loop mode. Default id otherwise.
+    */
+    std::atomic<std::thread::id> dispatchThread;
+
+    /* Tables replaced by listeners themselves, freed by next change. */
+    std::vector<AsyncListenerTable*> retiredListeners;
 
-    /* Registered listener of asynchronous messages reception. */
-    AsyncMsgListenerF asyncListener;
     void setAsyncListener(AsyncMsgListenerF listener);
+    unsigned int addAsyncListener(AsyncMsgListenerF listener, const AsyncMsgFilter& filter, bool legacy = false);
+    void removeAsyncListener(unsigned int id);
+
+    /* Publishes new table, returns replaced tables to be freed. */
+    std::vector<AsyncListenerTable*> publishAsyncListeners(AsyncListenerTable* table);
+
+    /* Frees replaced tables, when they are not in use. */
+    void freeAsyncListeners(const std::vector<AsyncListenerTable*>& replaced);
+
+    /* Passes DR data to matching listeners. */
+    void dispatchAsyncMessage(unsigned char* data, unsigned int length);
 
     /* Indicates, whether is reading thread stopped. */
     bool receptionStopped;
     void setReceptionStopped(bool value);
     bool getReceptionStopped(void);
 
+    /* Writer of running capture, NULL if capture is not running. */
+    CDCCaptureWriter* captureWriter;
+    void startCapture(const char* fileName);
+    void stopCapture(void);
+
+    /* Cached identification, valid until reset of the device. */
+    USBDeviceInfo deviceInfo;
+    bool deviceInfoValid;
+    ModuleInfo moduleInfo;
+    bool moduleInfoValid;
+    /* Incremented by each invalidation, older received info is not cached. */
+    unsigned int identificationGeneration;
+    USBDeviceInfo getUSBDeviceInfo(void);
+    ModuleInfo getTRModuleInfo(void);
+    void invalidateIdentification(bool device, bool module);
+
+    /*
+    * Cached SPI status, encoded by encodeStatus. Zero value means,
+    * that no status has been received yet.
+    */
+    std::atomic<uint32_t> cachedStatus;
+    static uint32_t encodeStatus(const SPIStatus& spiStatus);
+    static SPIStatus decodeStatus(uint32_t encodedStatus);
+
+    /* Parses S response and updates cached status. */
+    SPIStatus parseStatusResponse(ParsedMessage& response);
+    void updateCachedStatus(const SPIStatus& spiStatus);
+
+    /* Registered listener of SPI status changes. */
+    SPIStatusListenerF statusListener;
+    void setStatusListener(SPIStatusListenerF listener);
+
+    /* Thread refreshing cached status and its settings. */
+    std::thread statusMonitorHandle;
+    std::condition_variable statusMonitorCond;
+    bool statusMonitorRunning;
+    // requests come from the reading thread without locking csStatusMonitor
+    std::atomic<bool> statusRefreshRequested;
+    std::atomic<bool> refreshOnTraffic;
+    unsigned int statusInterval;
+    void startStatusMonitor(unsigned int interval, bool onTraffic);
+    void stopStatusMonitor(void);
+    void statusMonitorThread(void);
+
+    /* Requests refreshing of the status, if the monitor refreshes on traffic. */
+    void requestStatusRefresh(void);
+
+    /* Reconnecting after loss of the device. */
+    ReconnectOptions reconnect;
+    void setReconnect(const ReconnectOptions& options);
+    ReconnectOptions getReconnect(void);
+
+    /*
+    * Connection state, changed by the reading thread only. Generation is
+    * incremented by each loss of the device.
+    */
+    bool connected;
+    unsigned int connectionGeneration;
+    std::condition_variable connectionCond;
+    unsigned int getConnectionGeneration(void);
+
+    /* Registered listener of connection changes. */
+    ConnectionListenerF connectionListener;
+    void setConnectionListener(ConnectionListenerF listener);
+    void notifyConnection(bool value);
+
+    /* Closes lost port and wakes up command waiting for response. */
+    void disconnectTransport(void);
+
+    /* Waits for the device node and reopens the port, returns false on failure. */
+    bool reconnectTransport(void);
+
+    /* Sets reopened port and resumes pending commands. */
+    void connectTransport(CDCTransport* newTransport);
+
+    /* Sends command, if the device is connected. */
+    CDCStatus trySendConnected(Command& cmd, unsigned int& generation);
+
+    /* Waits for reconnection, if pending commands are replayed. */
+    bool waitForReplay(void);
+
+    /* Pacing of DS commands. */
+    PacingOptions pacing;
+    void setPacing(const PacingOptions& options);
+    PacingOptions getPacing(void);
+
+    /* Busy polling of the reading thread, time is 0 if disabled. */
+    std::atomic<unsigned int> busyPollTime;
+    void setBusyPoll(const BusyPollOptions& options);
+
+    /*
+    * The reading thread is busy polling. Sending thread extends polling by
+    * busyPollRenew, or wakes up the thread to start polling.
+    */
+    std::atomic<bool> readerSpinning;
+    std::atomic<bool> busyPollRenew;
+    void requestBusyPoll(void);
+
+    /* Counters of CDCMetrics. */
+    struct MetricCounters {
+        std::atomic<unsigned long long> receivedMessages;
+        std::atomic<unsigned long long> blockingReceptions;
+        std::atomic<unsigned long long> spinReceptions;
+        std::atomic<unsigned long long> spinTime;
+        std::atomic<unsigned long long> responses;
+        std::atomic<unsigned long long> responseLatency;
+        std::atomic<unsigned long long> badFrames;
+        std::atomic<unsigned long long> discardedBytes;
+    };
+    MetricCounters metrics;
+    CDCMetrics getMetrics(void);
+
+    /*
+    * Handler of queued command. It gets the response, if the status is OK,
+    * and converts it for callback of the application.
+    */
+    typedef std::function<void(const CDCStatus&, ParsedMessage&)> PendingHandlerF;
+
+    /* Command sent by one of *Async functions. */
+    struct PendingCommand {
+        FrameBytes bytes;
+        MessageType msgType;
+        bool download;
+        PendingHandlerF handler;
+        std::chrono::steady_clock::time_point deadline;
+        ParseContext expectedResponse;
+    };
+
+    /*
+    * Queue of commands sent by *Async functions. Only the first one is sent,
+    * the next one is sent after its response or timeout. No command is sent,
+    * while a synchronous command waits for response, so responses are
+    * received in order of sending.
+    */
+    typedef std::deque<PendingCommand, CDCAllocator<PendingCommand>> PendingQueue;
+    PendingQueue pendingCommands;
+    bool pendingSent;
+    size_t pendingWritten;
+    bool syncCommandActive;
+    std::condition_variable pendingCond;
+
+    /* Queues command, the handler is called on failure immediately. */
+    void queueCommand(Command& cmd, PendingHandlerF handler);
+
+    /* Sends the first queued command, if no command is being processed. */
+    void startPendingCommand(void);
+
+    /* Writes rest of the first queued command without blocking. */
+    CDCStatus writePendingCommand(void);
+
+    /* Finishes the first queued command by response, if it waits for it. */
+    bool completePendingCommand(ParsedMessage& response);
+
+    /* Finishes the first queued command, if its response timeouted. */
+    void processPendingTimeout(void);
+
+    /* Finishes all queued commands with specified error. */
+    void failPendingCommands(const CDCStatus& status);
+
+    /* Removes the first queued command and returns it. */
+    PendingCommand popPendingCommand(void);
+
+    /* Calls handler of finished command. */
+    void finishPendingCommand(PendingCommand& pendingCmd, const CDCStatus& status);
+
+    bool isWritePending(void);
+    int getTimerTimeout(void);
+
+    /* Marks synchronous command, queued commands are not sent meanwhile. */
+    CDCStatus beginSyncCommand(void);
+    void endSyncCommand(void);
+
+    /* Received data not processed yet in event loop mode. */
+    FrameBytes loopReceivedBytes;
+
+    /* Entry points of event loop mode. */
+    int getPollHandle(void);
+
+    /* Applies specified settings to started thread. */
+    static CDCStatus applyThreadOptions(std::thread& thread, const ThreadOptions& threadOptions);
+    CDCStatus onReadable(void);
+
+    /* Appends specified data into running capture. */
+    void captureData(CaptureDirection direction, const unsigned char* data, size_t dlen);
+
     /* Last reception error. */
     std::string lastReceptionError; //char* lastReceptionError;
     void setLastReceptionError(const std::string& descr);
@@ -128,12 +466,12 @@ public:
     /* Encapsulates basic initialization process. */
     void init(void);
 
+    /* Frees port, events and parser created by init. */
+    void releaseResources(void);
+
     /* Initializes messageHeaders map. */
     void initMessageHeaders(void);
 
-    /* Initializes lastResponse. */
-    void initLastResponse(void);
-
     /* Function of reading thread of incoming COM port messages. */
     int readMsgThread();
 
@@ -141,10 +479,13 @@ public:
     //int appendDataFromPort(LPOVERLAPPED overlap, ustring& destBuffer);
 
     /* Extracts and process all messages in specified buffer. */
-    void processAllMessages(ustring& msgBuffer);
+    void processAllMessages(FrameBytes& msgBuffer);
 
-    /* Parses next message string from specified buffer and returns it. */
-    ParsedMessage parseNextMessage(ustring& msgBuffer);
+    /* Parses next message string at specified position of the buffer and returns it. */
+    ParsedMessage parseNextMessage(FrameBytes& msgBuffer, size_t msgStart);
+
+    /* Returns position of the first valid message after bad frame at specified position. */
+    size_t findNextMessage(FrameBytes& msgBuffer, size_t badStart);
 
     /* Processes specified message - include parsing. */
     void processMessage(ParsedMessage& parsedMessage);
@@ -154,37 +495,134 @@ public:
 
     /* Construct command and returns it. */
     Command constructCommand(MessageType msgType, ustring data);
+    Command constructCommand(MessageType msgType, const unsigned char* data, unsigned int dlen);
 
     /* Sends command, waits for response a checks the response. */
-    void processCommand(Command& cmd);
+    ParsedMessage processCommand(Command& cmd);
+
+    /* Sends command, waits for response a checks the response, without exceptions. */
+    CDCStatus tryProcessCommand(Command& cmd, ParsedMessage& response);
+
+    /* Processing of synchronous command, called with locked csCommand. */
+    CDCStatus tryProcessSyncCommand(Command& cmd, ParsedMessage& response);
+
+    /* Waits for response of sent synchronous command. */
+    CDCStatus waitForResponse(ParsedMessage& response);
+
+    /* Sends DS command, paced by SPI status if pacing is enabled. */
+    CDCResult<DSResponse> processDataSend(Command& cmd);
+
+    /* Indicates, whether the module is able to accept DS command. */
+    bool isReadyStatus(const SPIStatus& spiStatus);
+
+    /* Sends DS commands by single write and waits for all their responses. */
+    void processDataSendBatch(const std::vector<ustring>& frames, std::vector<CDCResult<DSResponse>>& results);
+
+    /*
+    * Results of DS commands sent by sendDataBatch, collected by the reading
+    * thread. Only the last response is passed to responseSlot.
+    */
+    std::vector<CDCResult<DSResponse>> batchResponses;
+    size_t batchRemaining;
+
+    /* Collects response of batch, returns false if it has to be passed to responseSlot. */
+    bool collectBatchResponse(ParsedMessage& response);
 
     /* Sends command stored in buffer to COM port. */
     void sendCommand(Command& cmd);
 
+    /* Sends command stored in buffer to COM port, without exceptions. */
+    CDCStatus trySendCommand(Command& cmd);
+
+    /* Writes specified bytes to COM port, without exceptions. */
+    CDCStatus trySendBytes(const unsigned char* data, unsigned int dlen);
+
+    /* Throws exception corresponding to specified failed status. */
+    void throwError(const CDCStatus& status);
+
     /* Bufferize specified command for passing to COM-port. */
     BuffCommand commandToBuffer(Command& cmd);
 
+    /* Converts specified command to bytes. */
+    void commandToBytes(Command& cmd, FrameBytes& tmpStr);
+
+    /* Checks, if response of specified type belongs to the command. */
+    static bool isExpectedResponse(MessageType cmdType, bool download, MessageType responseType);
+
+    /* Indicates, whether specified UPLOAD_DOWNLOAD command is download. */
+    static bool isDownload(Command& cmd);
+
+    /* Returns response expected after specified command. */
+    ParseContext expectedResponseOf(Command& cmd);
+
+    /*
+    * Response of the last sent command, the parser delimits PM and IT frames
+    * by it. Set before the command is written.
+    */
+    ParseContext expectedResponse;
+    void setExpectedResponse(const ParseContext& context);
+    ParseContext getExpectedResponse(void);
+
+    /* Length of the last received TR module info, 0 if none was received. */
+    std::atomic<unsigned int> moduleInfoLength;
+
     /* Checks, if specified value is the correct value of SPIStatus. */
     bool isSPIStatusValue(ustring& statValue);
 
-    int appendDataFromPort(unsigned char* buf, unsigned buflen, ustring& destBuffer);
+    int appendDataFromPort(unsigned char* buf, unsigned buflen, FrameBytes& destBuffer);
 
     // critical section objects for thread safe access to some fields
     std::mutex csLastRecpError;
     std::mutex csReadingStopped;
     std::mutex csAsyncListener;
+    std::mutex csCapture;
+    std::mutex csPacing;
+    std::mutex csStatusListener;
+    std::mutex csIdentification;
+    std::mutex csReconnect;
+    std::mutex csConnectionListener;
+    // transport and connection state
+    std::mutex csTransport;
+    std::mutex csStatusMonitor;
+    // one command at a time waits for response
+    std::mutex csCommand;
+    // paced DS commands are sent in order
+    std::mutex csDataSend;
+    // queue of asynchronous DS commands, locked before csTransport
+    std::mutex csPendingCommands;
+    std::mutex csExpectedResponse;
+    std::mutex csBatch;
 
     //throws CDCReceiveException
     void setMyEvent(HANDLE evnt);
     void resetMyEvent(HANDLE evnt);
     void createMyEvent(HANDLE & evnt);
     void destroyMyEvent(HANDLE & evnt);
-    DWORD waitForMyEvent(HANDLE evnt, DWORD timeout);
+    void waitForMyEvent(HANDLE evnt, DWORD timeout);
+    CDCStatus tryWaitForMyEvent(HANDLE evnt, DWORD timeout);
 
-    HANDLE openPort(const std::string& portName);
+    HANDLE openPort(const std::string& portName, unsigned int settleDelay);
     void closePort(HANDLE & portHandle);
 
-    unsigned char* m_transmitBuffer;
-    DWORD m_transmitBufferLen;
+    /* Opens port, if no transport was specified, and sets portHandle. */
+    void openTransport(void);
+    void closeTransport(void);
+
+    /* Bytes of command being sent, used with locked csTransport. */
+    FrameBytes transmitBytes;
+
+    /*
+    * Allocator of buffers of frames and of queued commands, it takes memory
+    * from the resource specified in options.
+    */
+    CDCAllocator<unsigned char> frameAllocator;
+
+    /*
+    * Buffers of commands and received messages, preallocated in realtime
+    * mode. Capacities cover the longest frames.
+    */
+    CDCBufferPool framePool;
+    static const size_t FRAME_CAPACITY = 512;
+    static const size_t RECEIVE_CAPACITY = 4096;
 
 };
@@ -15,12 +15,16 @@
  */
 
 #include <sys/eventfd.h>
+#include <sys/inotify.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
 
 #include <sys/time.h>
 #include <unistd.h>
 #include <sys/select.h>
+#include <pthread.h>
+#include <sched.h>
 
 #include <iostream>
 #include <errno.h>
@@ -30,53 +34,156 @@
 #include <CDCMessageParser.h>
 #include <CDCImplPri.h>
 
-#include <set>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <thread>
 
 /* Information about what kind of event to wait for. */
 enum EventType { READ_EVENT, WRITE_EVENT };
 
-/* Wrapper for standard 'select' function. */
-int selectEvents(std::set<int>& fds, EventType evType, unsigned int timeout);
+/* Wrapper for standard 'select' function with single descriptor. */
+int selectEvent(int fd, EventType evType, unsigned int timeout);
+
+/* Period of reopening attempts, if no inotify event arrives [ms]. */
+static const int TM_REOPEN_PERIOD = 500;
 
 /*
  *	Function of reading thread of incoming COM-port messages.
  */
 int CDCImplPrivate::readMsgThread()
 {
-    ustring receivedBytes;
+    FrameBytes receivedBytes(frameAllocator);
     fd_set waitEvents;
+    fd_set writeEvents;
     std::string errorDescr;
     const size_t BUFF_SIZE = 1024;
     unsigned char buffer[BUFF_SIZE];
 
+    // no reallocation in realtime mode
+    if (options.realtime)
+        receivedBytes.reserve(RECEIVE_CAPACITY);
 
-    try  {
-        int maxEventNum = ((portHandle > readEndEvent)? portHandle:readEndEvent) + 1;
+    // busy polling window
+    typedef std::chrono::steady_clock Clock;
+    bool spinning = false;
+    Clock::time_point spinStart;
+    Clock::time_point spinEnd;
 
+    try  {
         // signal for main thread to continue with initialization
         setMyEvent(readStartEvent);
 
         bool run = true;
         receivedBytes.clear();
         while (run) {
+            // port handle changes by reconnecting
+            int maxEventNum = std::max(std::max(portHandle, readEndEvent), readWakeEvent) + 1;
+
             FD_ZERO(&waitEvents);
             FD_SET(portHandle, &waitEvents);
             FD_SET(readEndEvent, &waitEvents);
+            FD_SET(readWakeEvent, &waitEvents);
+
+            // rest of command queued by sendDataAsync
+            FD_ZERO(&writeEvents);
+            if (isWritePending())
+                FD_SET(portHandle, &writeEvents);
+
+            // deadline of command queued by sendDataAsync
+            struct timeval timerTimeout;
+            struct timeval* timerTimeoutPtr = NULL;
+            int timerMs = getTimerTimeout();
+            if (timerMs >= 0) {
+                timerTimeout.tv_sec = timerMs / 1000;
+                timerTimeout.tv_usec = (timerMs % 1000) * 1000;
+                timerTimeoutPtr = &timerTimeout;
+            }
 
-            int waitResult = select(maxEventNum, &waitEvents, NULL, NULL, NULL);
+            // busy polling does not wait at all
+            bool polling = spinning;
+            if (polling) {
+                timerTimeout.tv_sec = 0;
+                timerTimeout.tv_usec = 0;
+                timerTimeoutPtr = &timerTimeout;
+            }
+
+            int waitResult = select(maxEventNum, &waitEvents, &writeEvents, NULL, timerTimeoutPtr);
             switch (waitResult) {
             case -1:
                 THROW_EXCEPT(CDCReceiveException, "Waiting for event in read cycle failed with error " << errno);
                 break;
             case 0:
                 // only in the case of timeout period expires
+                processPendingTimeout();
+
+                if (!polling)
+                    break;
+
+                // polling is over, unless sending thread has extended it
+                if (busyPollRenew.exchange(false)) {
+                    spinEnd = Clock::now() + std::chrono::microseconds(busyPollTime.load());
+                } else if (Clock::now() >= spinEnd) {
+                    readerSpinning = false;
+                    if (busyPollRenew.exchange(false)) {
+                        readerSpinning = true;
+                        spinEnd = Clock::now() + std::chrono::microseconds(busyPollTime.load());
+                        break;
+                    }
+
+                    spinning = false;
+                    metrics.spinTime.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - spinStart).count(), std::memory_order_relaxed);
+                }
                 break;
             default:
+                if (FD_ISSET(readWakeEvent, &waitEvents))
+                    resetMyEvent(readWakeEvent);
+
+                if (FD_ISSET(portHandle, &writeEvents))
+                    writePendingCommand();
+
                 // read in characters into input buffer
                 if (FD_ISSET(portHandle, &waitEvents)) {
-                    int messageEnd = appendDataFromPort(buffer, BUFF_SIZE, receivedBytes);
+                    int messageEnd = -1;
+                    try {
+                        messageEnd = appendDataFromPort(buffer, BUFF_SIZE, receivedBytes);
+                    } catch (CDCReceiveException& e) {
+                        if (!transportOwned || !getReconnect().enabled)
+                            throw;
+
+                        setLastReceptionError(e.what());
+                        disconnectTransport();
+                        failPendingCommands(CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED));
+                        if (!reconnectTransport())
+                            throw;
+
+                        // data of lost connection are incomplete
+                        receivedBytes.clear();
+                        continue;
+                    }
+
                     if (messageEnd != -1)
                         processAllMessages(receivedBytes);
+
+                    if (polling)
+                        metrics.spinReceptions.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        metrics.blockingReceptions.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                processPendingTimeout();
+
+                // each send or receive starts or extends busy polling
+                unsigned int spinTime = busyPollTime.load();
+                if (spinTime > 0) {
+                    if (!spinning) {
+                        spinning = true;
+                        readerSpinning = true;
+                        spinStart = Clock::now();
+                    }
+                    busyPollRenew = false;
+                    spinEnd = Clock::now() + std::chrono::microseconds(spinTime);
                 }
 
                 // read end
@@ -84,36 +191,223 @@ int CDCImplPrivate::readMsgThread()
                     run = false; //goto READ_END;
             }
         }
+
+        readerSpinning = false;
     }
     catch (CDCReceiveException &e) {
         setLastReceptionError(e.what());
         setReceptionStopped(true);
+        failPendingCommands(CDCStatus(CDCErrorCode::RECEPTION_STOPPED));
         return 1;
     }
 
     return 0;
 }
 
+/*
+ * Entry point of event loop mode. Reads all data available on the port
+ * and processes complete messages. The port is non-blocking in this mode.
+ * @return status of reading
+ */
+CDCStatus CDCImplPrivate::onReadable(void)
+{
+    if (getReceptionStopped())
+        return CDCStatus(CDCErrorCode::RECEPTION_STOPPED);
+
+    const size_t BUFF_SIZE = 1024;
+    unsigned char buffer[BUFF_SIZE];
+
+    try {
+        bool messageEnd = false;
+        for (;;) {
+            size_t receivedLen = loopReceivedBytes.size();
+            if (appendDataFromPort(buffer, BUFF_SIZE, loopReceivedBytes) != -1)
+                messageEnd = true;
+
+            // no other data available
+            if (loopReceivedBytes.size() == receivedLen)
+                break;
+        }
+
+        if (messageEnd)
+            processAllMessages(loopReceivedBytes);
+    }
+    catch (CDCReceiveException &e) {
+        int error = errno;
+        setLastReceptionError(e.what());
+        setReceptionStopped(true);
+        failPendingCommands(CDCStatus(CDCErrorCode::RECEPTION_STOPPED));
+        return CDCStatus(CDCErrorCode::RECEIVE_FAILED, error);
+    }
+
+    return CDCStatus();
+}
+
+int CDCImplPrivate::getPollHandle(void)
+{
+    return portHandle;
+}
+
+/*
+ * Applies name, CPU affinity and scheduling policy to specified thread.
+ * @return status of applying, with error code of failed pthread function
+ */
+CDCStatus CDCImplPrivate::applyThreadOptions(std::thread& thread, const ThreadOptions& threadOptions)
+{
+    pthread_t handle = thread.native_handle();
+
+    if (!threadOptions.name.empty()) {
+        // longer names are refused
+        std::string name = threadOptions.name.substr(0, 15);
+        int result = pthread_setname_np(handle, name.c_str());
+        if (result != 0)
+            return CDCStatus(CDCErrorCode::INTERNAL_ERROR, result);
+    }
+
+    if (!threadOptions.cpus.empty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (unsigned int cpu : threadOptions.cpus) {
+            if (cpu >= CPU_SETSIZE)
+                return CDCStatus(CDCErrorCode::INVALID_ARGUMENT);
+            CPU_SET(cpu, &cpuSet);
+        }
+
+        int result = pthread_setaffinity_np(handle, sizeof(cpuSet), &cpuSet);
+        if (result != 0)
+            return CDCStatus(CDCErrorCode::INTERNAL_ERROR, result);
+    }
+
+    if (threadOptions.policy != ThreadPolicy::DEFAULT) {
+        int policy = (threadOptions.policy == ThreadPolicy::FIFO)? SCHED_FIFO : SCHED_RR;
+        struct sched_param param;
+        param.sched_priority = threadOptions.priority;
+
+        int result = pthread_setschedparam(handle, policy, &param);
+        if (result != 0)
+            return CDCStatus(CDCErrorCode::INTERNAL_ERROR, result);
+    }
+
+    return CDCStatus();
+}
+
+/*
+ * Sends the first queued command, if no command is being sent and no
+ * synchronous command waits for response. The reading thread is woken up
+ * to wait for the deadline of the command.
+ */
+void CDCImplPrivate::startPendingCommand(void)
+{
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        if (pendingSent || syncCommandActive || pendingCommands.empty())
+            return;
+
+        pendingSent = true;
+        pendingWritten = 0;
+        pendingCommands.front().deadline = std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(options.responseTimeout);
+        setExpectedResponse(pendingCommands.front().expectedResponse);
+    }
+
+    writePendingCommand();
+
+    if (!options.eventLoop)
+        setMyEvent(readWakeEvent);
+}
+
+/*
+ * Writes rest of the first queued command, as much as the port accepts
+ * without blocking. Failed command is finished and the next one is sent.
+ * @return status of writing
+ */
+CDCStatus CDCImplPrivate::writePendingCommand(void)
+{
+    CDCStatus status;
+    PendingCommand failedCmd;
+    {
+        std::lock_guard<std::mutex> lck(csPendingCommands);
+        if (!pendingSent)
+            return status;
+
+        const FrameBytes& bytes = pendingCommands.front().bytes;
+        if (pendingWritten == bytes.size())
+            return status;
+
+        {
+            std::lock_guard<std::mutex> transportLck(csTransport);
+            if (!connected) {
+                status = CDCStatus(CDCErrorCode::DEVICE_DISCONNECTED);
+            } else {
+                if (pendingWritten == 0)
+                    captureData(CAPTURE_TX, bytes.data(), bytes.size());
+
+                int writeResult = transport->write(bytes.data() + pendingWritten,
+                    static_cast<unsigned int>(bytes.size() - pendingWritten));
+                if (writeResult == -1) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK)
+                        status = CDCStatus(CDCErrorCode::SEND_FAILED, errno);
+                } else {
+                    pendingWritten += writeResult;
+                }
+            }
+        }
+
+        if (!status)
+            failedCmd = popPendingCommand();
+        else if (pendingWritten == bytes.size())
+            pendingCond.notify_all();
+    }
+
+    if (!status) {
+        finishPendingCommand(failedCmd, status);
+        startPendingCommand();
+    }
+
+    return status;
+}
+
 /*
  * Reads data from port and appends them to specified buffer until no
  * other data are in input buffer of the port.
- * @return position of message end character present in the specified buffer <br>
- *		   -1, if no message end character was appended into specified buffer
+ * @return position of message end character present in the specified buffer,
+ *         or end of the buffer, if it is long enough for expected response <br>
+ *		   -1, if no message end was appended into specified buffer
  * @throw CDCReceiveException
  */
-int CDCImplPrivate::appendDataFromPort(unsigned char* buf, unsigned buflen, ustring& destBuffer)
+int CDCImplPrivate::appendDataFromPort(unsigned char* buf, unsigned buflen, FrameBytes& destBuffer)
 {
     int messageEnd = -1;
 
-    ssize_t readResult = read(portHandle, (void*)buf, buflen);
+    int readResult = transport->read(buf, buflen);
+
+    // no data on non-blocking port
+    if (readResult == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        return -1;
+
     if (readResult == -1)
         // error in communication
         THROW_EXCEPT(CDCReceiveException, "Appending data from COM-port failed with error " << errno);
 
+    if (readResult == 0)
+        THROW_EXCEPT(CDCReceiveException, "COM-port has been closed");
+
+    captureData(CAPTURE_RX, buf, readResult);
+
+    // only the new bytes can complete a message, older ones were scanned
+    const void* endPtr = memchr(buf, 0x0D, readResult);
+    if (endPtr != NULL)
+        messageEnd = static_cast<int>(destBuffer.size() + (static_cast<const unsigned char*>(endPtr) - buf));
+
     destBuffer.append(buf, readResult);
-    size_t endPos = destBuffer.find(0x0D);
-    if (endPos != std::string::npos)
-        messageEnd = endPos;
+
+    // PM and IT frames are delimited by expected length, their end can come
+    // without 0x0D among the new bytes
+    if (messageEnd == -1) {
+        ParseContext context = getExpectedResponse();
+        if (context.expectedLength != 0 && destBuffer.size() >= context.expectedLength)
+            messageEnd = static_cast<int>(destBuffer.size()) - 1;
+    }
 
     return messageEnd;
 }
@@ -121,31 +415,68 @@ int CDCImplPrivate::appendDataFromPort(unsigned char* buf, unsigned buflen, ustr
 /*
  * Sends command stored in buffer to COM port.
  * @param cmd command to send to COM-port.
+ * @return status of sending
  */
-void CDCImplPrivate::sendCommand(Command& cmd)
+CDCStatus CDCImplPrivate::trySendCommand(Command& cmd)
 {
     BuffCommand buffCmd = commandToBuffer(cmd);
-    unsigned char* dataToWrite = buffCmd.cmd;
-    int dataLen = buffCmd.len;
 
-    std::set<int> fds;
-    fds.insert(portHandle);
+    // response to previous timeouted command
+    responseSlot.reset();
+    setExpectedResponse(expectedResponseOf(cmd));
+
+    return trySendBytes(buffCmd.cmd, buffCmd.len);
+}
+
+/*
+ * Writes specified bytes to COM port. Bytes accepted by the port at once
+ * are written by single write.
+ * @return status of sending
+ */
+CDCStatus CDCImplPrivate::trySendBytes(const unsigned char* data, unsigned int dlen)
+{
+    const unsigned char* dataToWrite = data;
+    int dataLen = static_cast<int>(dlen);
+
+    captureData(CAPTURE_TX, dataToWrite, dataLen);
 
     while (dataLen > 0) {
-        int selResult = selectEvents(fds, WRITE_EVENT, TM_SEND_MSG);
+        int selResult = selectEvent(portHandle, WRITE_EVENT, TM_SEND_MSG);
         if (selResult == -1)
-            THROW_EXCEPT(CDCSendException, "Sending message failed with error " << errno);
+            return CDCStatus(CDCErrorCode::SEND_FAILED, errno);
 
         if (selResult == 0)
-            throw CDCSendException("Waiting for send timeouted");
+            return CDCStatus(CDCErrorCode::SEND_TIMEOUT);
+
+        int writeResult = transport->write(dataToWrite, dataLen);
+
+        // non-blocking port is full
+        if (writeResult == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            continue;
 
-        int writeResult = write(portHandle, dataToWrite, dataLen);
         if (writeResult == -1)
-            THROW_EXCEPT(CDCSendException, "Sending message failed with error " << errno);
+            return CDCStatus(CDCErrorCode::SEND_FAILED, errno);
 
         dataLen -= writeResult;
         dataToWrite += writeResult;
     }
+
+    requestBusyPoll();
+    return CDCStatus();
+}
+
+/*
+ * Makes the reading thread to poll for the response of sent command. Polling
+ * thread only extends the polling, otherwise it is woken up to start it.
+ */
+void CDCImplPrivate::requestBusyPoll(void)
+{
+    if (options.eventLoop || busyPollTime.load() == 0)
+        return;
+
+    busyPollRenew = true;
+    if (!readerSpinning.load())
+        setMyEvent(readWakeEvent);
 }
 
 /////////////////////////////////////////////////////////
@@ -159,8 +490,16 @@ void CDCImplPrivate::setMyEvent(HANDLE evnt)
 
 void CDCImplPrivate::resetMyEvent(HANDLE evnt)
 {
-    (void)evnt;
-    //TODO empty
+    struct pollfd eventFd;
+    eventFd.fd = evnt;
+    eventFd.events = POLLIN;
+    eventFd.revents = 0;
+
+    // reading resets counter of eventfd to zero
+    uint64_t eventData = 0;
+    if (poll(&eventFd, 1, 0) > 0)
+        if (read(evnt, &eventData, sizeof(uint64_t)) == -1)
+            THROW_EXCEPT(CDCImplException, "Resetting event failed with error " << errno);
 }
 
 void CDCImplPrivate::createMyEvent(HANDLE & event)
@@ -177,35 +516,34 @@ void CDCImplPrivate::destroyMyEvent(HANDLE & event)
 
 /*
  * Blocks, until specified event is not in signaling state.
- * If timeout is not 0, waits at max for specified timeout(in seconds).
+ * If timeout is not 0, waits at max for specified timeout(in milliseconds).
  */
-DWORD CDCImplPrivate::waitForMyEvent(HANDLE evnt, DWORD timeout)
+CDCStatus CDCImplPrivate::tryWaitForMyEvent(HANDLE evnt, DWORD timeout)
 {
-    std::set<int> events;
-    events.insert(evnt);
-    int waitResult = selectEvents(events, READ_EVENT, timeout);
+    int waitResult = selectEvent(evnt, READ_EVENT, timeout);
 
     switch (waitResult) {
     case -1:
-        THROW_EXCEPT(CDCReceiveException, "Waiting in selectEvents failed with error " << errno);
-        break;
+        return CDCStatus(CDCErrorCode::RECEIVE_FAILED, errno);
     case 0:
-        THROW_EXCEPT(CDCReceiveException, "Waiting for event timeout");
-        break;
+        return CDCStatus(CDCErrorCode::RESPONSE_TIMEOUT);
     default:
         // OK
         //TODO aditional check - is it necessary here?
         uint64_t respData = 0;
         if (read(evnt, &respData, sizeof(uint_fast64_t)) == -1)
-            THROW_EXCEPT(CDCReceiveException, "Waiting for response failed with error " << errno);
+            return CDCStatus(CDCErrorCode::RECEIVE_FAILED, errno);
         break;
     }
-    return waitResult;
+    return CDCStatus();
 }
 
 
-/* Configures and opens port for communication. */
-HANDLE CDCImplPrivate::openPort(const std::string& portName)
+/*
+ * Configures and opens port for communication.
+ * @param settleDelay delay before flushing the port in milliseconds
+ */
+HANDLE CDCImplPrivate::openPort(const std::string& portName, unsigned int settleDelay)
 {
     HANDLE portHandle = open(portName.c_str(), O_RDWR | O_NOCTTY);
 
@@ -213,14 +551,20 @@ HANDLE CDCImplPrivate::openPort(const std::string& portName)
     if (portHandle == -1)
         THROW_EXCEPT(CDCImplException, "Port handle creation failed with error " << errno);
 
-    if (isatty(portHandle) == 0)
-        THROW_EXCEPT(CDCImplException, "Specified file is not associated with terminal " << errno);
+    if (isatty(portHandle) == 0) {
+        int error = errno;
+        close(portHandle);
+        THROW_EXCEPT(CDCImplException, "Specified file is not associated with terminal " << error);
+    }
 
     struct termios portOptions;
 
     // get current settings of the serial port
-    if (tcgetattr(portHandle, &portOptions) == -1)
-        THROW_EXCEPT(CDCImplException, "Port parameters getting failed with error " << errno);
+    if (tcgetattr(portHandle, &portOptions) == -1) {
+        int error = errno;
+        close(portHandle);
+        THROW_EXCEPT(CDCImplException, "Port parameters getting failed with error " << error);
+    }
 
     /*
      * Turn of:
@@ -257,15 +601,20 @@ HANDLE CDCImplPrivate::openPort(const std::string& portName)
     portOptions.c_cc[VMIN] = 1;
     portOptions.c_cc[VTIME] = 0;
 
-    if (tcsetattr(portHandle, TCSANOW, &portOptions) == -1)
-        THROW_EXCEPT(CDCImplException, "Port parameters setting failed with error " << errno);
+    if (tcsetattr(portHandle, TCSANOW, &portOptions) == -1) {
+        int error = errno;
+        close(portHandle);
+        THROW_EXCEPT(CDCImplException, "Port parameters setting failed with error " << error);
+    }
 
     // required to make flush to work because of Linux kernel bug
-    if ( sleep(2) != 0 )
-        THROW_EXCEPT(CDCImplException, "Sleeping before flushing the port not elapsed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(settleDelay));
 
-    if ( tcflush(portHandle, TCIOFLUSH) != 0 )
-        THROW_EXCEPT(CDCImplException, "Port flushing failed with error" << errno);
+    if ( tcflush(portHandle, TCIOFLUSH) != 0 ) {
+        int error = errno;
+        close(portHandle);
+        THROW_EXCEPT(CDCImplException, "Port flushing failed with error" << error);
+    }
 
     return portHandle;
 }
@@ -275,46 +624,138 @@ void CDCImplPrivate::closePort(HANDLE & portHandle)
     close(portHandle);
 }
 
-/////////////////////////////////////
-/* Wrapper for standard 'select' function. */
-int selectEvents(std::set<int>& fds, EventType evType, unsigned int timeout)
+void CDCImplPrivate::openTransport(void)
 {
-    if (fds.empty())
-        return 0;
-
-    int maxFd = 0;
-    fd_set selFds;
-    FD_ZERO(&selFds);
+    transportOwned = (transport == NULL);
+    if (transportOwned)
+        transport = ant_new CDCFdTransport(openPort(m_commPort, options.settleDelay));
+
+    portHandle = transport->getHandle();
+
+    // the event loop must not be blocked
+    if (options.eventLoop) {
+        int flags = fcntl(portHandle, F_GETFL);
+        if (flags == -1 || fcntl(portHandle, F_SETFL, flags | O_NONBLOCK) == -1) {
+            int error = errno;
+            delete transport;
+            transport = NULL;
+            THROW_EXCEPT(CDCImplException, "Port non-blocking mode setting failed with error " << error);
+        }
+    }
+}
 
-    std::set<int>::iterator fdsIt = fds.begin();
-    for (;fdsIt != fds.end(); fdsIt++) {
-        FD_SET(*fdsIt, &selFds);
-        if (*fdsIt > maxFd)
-            maxFd = (*fdsIt);
+/*
+ * Waits for the device node of lost port to reappear and reopens the port.
+ * The directory of the node is watched by inotify, reopening is also
+ * attempted periodically, because the node can become accessible later
+ * than it is created.
+ * @return false if waiting timeouted or the reading thread is ending
+ */
+bool CDCImplPrivate::reconnectTransport(void)
+{
+    ReconnectOptions reconnectOptions = getReconnect();
+
+    size_t slashPos = m_commPort.find_last_of('/');
+    std::string nodeDir = (slashPos == std::string::npos)? "." : m_commPort.substr(0, slashPos + 1);
+    std::string nodeName = (slashPos == std::string::npos)? m_commPort : m_commPort.substr(slashPos + 1);
+
+    // without inotify the port is only reopened periodically
+    int inotifyFd = inotify_init1(IN_CLOEXEC);
+    if (inotifyFd != -1
+            && inotify_add_watch(inotifyFd, nodeDir.c_str(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) == -1)
+    {
+        close(inotifyFd);
+        inotifyFd = -1;
     }
 
-    maxFd++;
-    if (timeout != 0) {
-        struct timeval waitTime;
-        waitTime.tv_sec = timeout;
-        waitTime.tv_usec = 0;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(reconnectOptions.timeout);
+
+    bool reconnected = false;
+    bool openPending = true;
+    for (;;) {
+        if (openPending) {
+            HANDLE newHandle = -1;
+            try {
+                newHandle = openPort(m_commPort, reconnectOptions.settleDelay);
+            } catch (CDCImplException&) {
+                // node does not exist or it is not accessible yet
+            }
 
-        if (evType == READ_EVENT)
-            return select(maxFd, &selFds, NULL, NULL, &waitTime);
+            if (newHandle != -1) {
+                connectTransport(ant_new CDCFdTransport(newHandle));
+                reconnected = true;
+                break;
+            }
+        }
 
-        if (evType == WRITE_EVENT)
-            return select(maxFd, NULL, &selFds, NULL, &waitTime);
+        int waitTime = TM_REOPEN_PERIOD;
+        if (reconnectOptions.timeout != 0) {
+            Clock::time_point now = Clock::now();
+            if (now >= deadline)
+                break;
+            long long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            if (remaining < waitTime)
+                waitTime = static_cast<int>(remaining) + 1;
+        }
 
-        // no other event type - params error
-        return -1;
+        struct pollfd waitEvents[2];
+        waitEvents[0].fd = readEndEvent;
+        waitEvents[0].events = POLLIN;
+        waitEvents[1].fd = inotifyFd;
+        waitEvents[1].events = POLLIN;
+        int waitResult = poll(waitEvents, (inotifyFd == -1)? 1 : 2, waitTime);
+        if (waitResult == -1 && errno != EINTR)
+            break;
+
+        // reading thread is ending
+        if (waitResult > 0 && (waitEvents[0].revents & POLLIN))
+            break;
+
+        // periodic attempt
+        openPending = (waitResult == 0);
+
+        if (waitResult > 0 && (waitEvents[1].revents & POLLIN)) {
+            alignas(struct inotify_event) char eventBuffer[4096];
+            ssize_t eventsLen = read(inotifyFd, eventBuffer, sizeof(eventBuffer));
+            for (ssize_t pos = 0; pos < eventsLen; ) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(eventBuffer + pos);
+                if (event->len != 0 && nodeName == event->name)
+                    openPending = true;
+                pos += sizeof(struct inotify_event) + event->len;
+            }
+        }
     }
 
-    if (evType == READ_EVENT)
-        return select(maxFd, &selFds, NULL, NULL, NULL);
+    if (inotifyFd != -1)
+        close(inotifyFd);
+
+    return reconnected;
+}
 
-    if (evType == WRITE_EVENT)
-        return select(maxFd, NULL, &selFds, NULL, NULL);
+void CDCImplPrivate::closeTransport(void)
+{
+    delete transport;
+    transport = NULL;
+}
+
+/////////////////////////////////////
+/* Wrapper for standard 'select' function with single descriptor. */
+int selectEvent(int fd, EventType evType, unsigned int timeout)
+{
+    fd_set selFds;
+    FD_ZERO(&selFds);
+    FD_SET(fd, &selFds);
+
+    fd_set* readFds = (evType == READ_EVENT)? &selFds : NULL;
+    fd_set* writeFds = (evType == WRITE_EVENT)? &selFds : NULL;
+
+    if (timeout != 0) {
+        struct timeval waitTime;
+        waitTime.tv_sec = timeout / 1000;
+        waitTime.tv_usec = (timeout % 1000) * 1000;
+        return select(fd + 1, readFds, writeFds, NULL, &waitTime);
+    }
 
-    // no other event type - params error
-    return -1;
+    return select(fd + 1, readFds, writeFds, NULL, NULL);
 }
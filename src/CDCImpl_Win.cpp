@@ -53,9 +53,13 @@ LPTSTR getCompletePortName(LPCTSTR portName);
 int CDCImplPrivate::readMsgThread()
 {
     DWORD eventFlags = EV_RXCHAR;
-    ustring receivedBytes;
+    FrameBytes receivedBytes(frameAllocator);
     receivedBytes.clear();
 
+    // no reallocation in realtime mode
+    if (options.realtime)
+        receivedBytes.reserve(RECEIVE_CAPACITY);
+
     DWORD bytesTotal = 0;
     unsigned char byteRead = '\0';
 
@@ -170,6 +174,7 @@ int CDCImplPrivate::readMsgThread()
                         //cout << "Read byte:" << byteRead << endl;
                         //cout << "TotalBytes:" << bytesTotal << endl;
 
+                        captureData(CAPTURE_RX, &byteRead, 1);
                         receivedBytes.push_back(byteRead);
 
                         if (byteRead == 0x0D) {
@@ -204,6 +209,7 @@ int CDCImplPrivate::readMsgThread()
 
                             if (bytesTotal != 0) {
                                 //cout << "Read byte:" << byteRead << endl;
+                                captureData(CAPTURE_RX, &byteRead, 1);
                                 receivedBytes.push_back(byteRead);
                             }
 
@@ -267,39 +273,54 @@ int CDCImplPrivate::readMsgThread()
  * Sends command stored in buffer to COM port.
  * @param cmd command to send to COM-port.
  */
-void CDCImplPrivate::sendCommand(Command& cmd)
+CDCStatus CDCImplPrivate::trySendCommand(Command& cmd)
 {
-    resetMyEvent(newMsgEvent);
+    responseSlot.reset();
+    setExpectedResponse(expectedResponseOf(cmd));
 
+    BuffCommand buffCmd = commandToBuffer(cmd);
+    return trySendBytes(buffCmd.cmd, buffCmd.len);
+}
+
+/*
+ * Writes specified bytes to COM port by single overlapped write.
+ */
+CDCStatus CDCImplPrivate::trySendBytes(const unsigned char* data, unsigned int dlen)
+{
     OVERLAPPED overlap;
     //SecureZeroMemory(&overlap, sizeof(OVERLAPPED));
     memset(&overlap, 0, sizeof(OVERLAPPED));
 
     overlap.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
     if (overlap.hEvent == NULL)
-        THROW_EXCEPT(CDCSendException, "Creating send event failed with error " << GetLastError());
+        return CDCStatus(CDCErrorCode::SEND_FAILED, GetLastError());
 
-    BuffCommand buffCmd = commandToBuffer(cmd);
+    captureData(CAPTURE_TX, data, dlen);
+    CDCStatus status;
     DWORD bytesWritten = 0;
-    if (!WriteFile(portHandle, buffCmd.cmd, buffCmd.len, &bytesWritten, &overlap)) {
+    if (!WriteFile(portHandle, data, dlen, &bytesWritten, &overlap)) {
         if (GetLastError() != ERROR_IO_PENDING) {
-            THROW_EXCEPT(CDCSendException, "Sending message failed with error " << GetLastError());
+            status = CDCStatus(CDCErrorCode::SEND_FAILED, GetLastError());
         } else {
             DWORD waitResult = WaitForSingleObject(overlap.hEvent, TM_SEND_MSG);
             switch (waitResult) {
             case WAIT_OBJECT_0:
                 if (!GetOverlappedResult(portHandle, &overlap, &bytesWritten, FALSE)) {
-                    THROW_EXCEPT(CDCSendException, "Waiting for send failed with error " << GetLastError());
+                    status = CDCStatus(CDCErrorCode::SEND_FAILED, GetLastError());
                 } else {
                     // Write operation completed successfully
                 }
                 break;
 
             case WAIT_TIMEOUT:
-                THROW_EXCEPT(CDCSendException, "Waiting for send timeouted");
+                // the write must not complete into released overlapped structure
+                CancelIo(portHandle);
+                status = CDCStatus(CDCErrorCode::SEND_TIMEOUT);
+                break;
 
             default:
-                THROW_EXCEPT(CDCSendException, "Waiting for send failed with error " << GetLastError());
+                status = CDCStatus(CDCErrorCode::SEND_FAILED, GetLastError());
+                break;
             }
         }
     } else {
@@ -307,6 +328,7 @@ void CDCImplPrivate::sendCommand(Command& cmd)
     }
 
     CloseHandle(overlap.hEvent);
+    return status;
 }
 
 ///////////////////////////////////////////
@@ -340,26 +362,28 @@ void CDCImplPrivate::destroyMyEvent(HANDLE & evnt)
 *		    WAIT_TIMEOUT - waiting timeouted
 *			other value - error
 */
-DWORD CDCImplPrivate::waitForMyEvent(HANDLE evnt, DWORD timeout)
+CDCStatus CDCImplPrivate::tryWaitForMyEvent(HANDLE evnt, DWORD timeout)
 {
-    std::stringstream excStream;
     DWORD waitResult = WaitForSingleObject(evnt, timeout);
     switch (waitResult) {
     case WAIT_OBJECT_0:
         // OK
         break;
     case WAIT_TIMEOUT:
-        THROW_EXCEPT(CDCReceiveException, "Waiting for event timeouted");
+        return CDCStatus(CDCErrorCode::RESPONSE_TIMEOUT);
     default:
-        THROW_EXCEPT(CDCReceiveException, "WaitForSingleObject failed with error " << GetLastError());
+        return CDCStatus(CDCErrorCode::RECEIVE_FAILED, GetLastError());
     }
 
-    return waitResult;
+    return CDCStatus();
 }
 
 /* Configures and opens port for communication. */
-HANDLE CDCImplPrivate::openPort(const std::string& portName)
+HANDLE CDCImplPrivate::openPort(const std::string& portName, unsigned int settleDelay)
 {
+    // port is not flushed after opening
+    (void)settleDelay;
+
     std::string portNameU(portName);
     if (portNameU.empty())
         portNameU = "COM1";
@@ -439,6 +463,62 @@ void CDCImplPrivate::closePort(HANDLE & portHandle)
   CloseHandle(portHandle);
 }
 
+void CDCImplPrivate::openTransport(void)
+{
+    if (transport != NULL) {
+        delete transport;
+        transport = NULL;
+        THROW_EXCEPT(CDCImplException, "Custom transports are not supported on this platform");
+    }
+
+    if (options.eventLoop)
+        THROW_EXCEPT(CDCImplException, "Event loop mode is not supported on this platform");
+
+    transportOwned = true;
+    portHandle = openPort(m_commPort, options.settleDelay);
+}
+
+int CDCImplPrivate::getPollHandle(void)
+{
+    THROW_EXCEPT(CDCImplException, "Event loop mode is not supported on this platform");
+}
+
+CDCStatus CDCImplPrivate::onReadable(void)
+{
+    return CDCStatus(CDCErrorCode::INTERNAL_ERROR);
+}
+
+/* Asynchronous commands are not supported on this platform. */
+void CDCImplPrivate::startPendingCommand(void)
+{
+    failPendingCommands(CDCStatus(CDCErrorCode::INTERNAL_ERROR));
+}
+
+CDCStatus CDCImplPrivate::writePendingCommand(void)
+{
+    return CDCStatus();
+}
+
+/* Only default settings are supported on this platform. */
+CDCStatus CDCImplPrivate::applyThreadOptions(std::thread& thread, const ThreadOptions& threadOptions)
+{
+    if (threadOptions.policy != ThreadPolicy::DEFAULT || !threadOptions.cpus.empty()
+            || !threadOptions.name.empty())
+        return CDCStatus(CDCErrorCode::INVALID_ARGUMENT);
+
+    return CDCStatus();
+}
+
+/* Busy polling is not supported on this platform. */
+void CDCImplPrivate::requestBusyPoll(void)
+{
+}
+
+void CDCImplPrivate::closeTransport(void)
+{
+    closePort(portHandle);
+}
+
 /////////////////////////////////////
 /*
 * Converts specified character string to wide-character string and returns it.
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <string>
 #include <set>
 #include <map>
@@ -27,7 +28,7 @@
  */
 class CDCMessageParserPrivate {
 public:
-    CDCMessageParserPrivate();
+    CDCMessageParserPrivate(ParserMode mode);
     ~CDCMessageParserPrivate();
 
     /* Information about state. */
@@ -78,12 +79,12 @@ public:
     // map of all transitions between states
     stateInputToStateMap transitionMap;
 
-    // last parsed data
-    ustring lastParsedData;
-
     // last parse result information
     ParseResult lastParseResult;
 
+    // implementation of parsing
+    ParserMode mode;
+
     /* Set of all values of SPIModes. */
     std::set<SPIModes> spiModes;
 
@@ -115,20 +116,25 @@ public:
 
     /* SPECIAL STATES PROCESSING. */
     /* Processes state 17. */
-    StateProcResult processUSBInfo(ustring& data, unsigned int pos);
+    StateProcResult processUSBInfo(ustring_view data, unsigned int pos);
 
     /* Processes state 21. */
-    StateProcResult processTRInfo(ustring& data, unsigned int pos);
+    StateProcResult processTRInfo(ustring_view data, unsigned int pos, const ParseContext& context);
 
     /* Processes state 50. */
-    StateProcResult processAsynData(ustring& data, unsigned int pos);
+    StateProcResult processAsynData(ustring_view data, unsigned int pos);
 
     /* Processes state 95. */
-    StateProcResult processPMRespData(ustring& data, unsigned int pos);
+    StateProcResult processPMRespData(ustring_view data, unsigned int pos, const ParseContext& context);
 
     /* Switch function of processing some special state. */
-    StateProcResult processSpecialState(unsigned int state, ustring& data,
-        unsigned int pos);
+    StateProcResult processSpecialState(unsigned int state, ustring_view data,
+        unsigned int pos, const ParseContext& context);
+
+
+    /* FAST PATHS. */
+    /* Parses DR message by its length, returns false if the FSM must parse the data. */
+    bool parseAsyncData(ustring_view data);
 
 
     /* Indicates, whether specified state is final state. */
@@ -141,7 +147,7 @@ public:
     unsigned int doTransition(unsigned int state, unsigned char input);
 
     /* Parses specified data. */
-    ParseResult parseData(ustring& data);
+    ParseResult parseData(ustring_view data, const ParseContext& context);
 };
 
 
@@ -283,7 +289,7 @@ void CDCMessageParserPrivate::initStatesInfoMap(void)
 
     unsigned int resUploadDownload[] = { 80, 81, 82, 83, 84, 85, 86,
                                          87, 88, 89, 90, 91, 92, 93};
-    insertStatesInfo(resUploadDownload, 17,  MSG_UPLOAD_DOWNLOAD);
+    insertStatesInfo(resUploadDownload, 14,  MSG_UPLOAD_DOWNLOAD);
 
     unsigned int dataDownload[] = { 96, 97 };
     insertStatesInfo(dataDownload, 2,  MSG_DOWNLOAD_DATA);
@@ -498,7 +504,8 @@ void CDCMessageParserPrivate::initSpiModes()
     spiModes.insert(HW_ERROR);
 }
 
-CDCMessageParserPrivate::CDCMessageParserPrivate()
+CDCMessageParserPrivate::CDCMessageParserPrivate(ParserMode mode)
+    :mode(mode)
 {
     initStatesInfoMap();
     initTransitionMap();
@@ -551,8 +558,45 @@ bool checkUSBDeviceId(unsigned char byteToCheck)
     return false;
 }
 
+/* Indicates, whether specified byte starts a message. */
+static bool isFrameStart(unsigned char byteToCheck)
+{
+    return byteToCheck == '<' || byteToCheck == '>';
+}
+
+/* Indicates, whether complete error code or BUSY of PM response is at specified position. */
+static bool isPMErrorCode(ustring_view data, size_t pos)
+{
+    ustring_view body = data.substr(pos, 5);
+    if (body.size() < 5 || body[4] != 0x0D)
+        return false;
+
+    if (body.compare(0, 4, uchar_str("BUSY")) == 0)
+        return true;
+
+    return body.compare(0, 3, uchar_str("ERR")) == 0 && body[3] >= '2' && body[3] <= '7';
+}
 
-CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processUSBInfo(ustring& data,
+/* Indicates, whether incomplete error code or BUSY of PM response is at specified position. */
+static bool isPMErrorCodePrefix(ustring_view data, size_t pos)
+{
+    ustring_view body = data.substr(pos);
+    if (body.empty() || body.size() >= 5)
+        return false;
+
+    ustring_view busy(uchar_str("BUSY\r"), 5);
+    if (busy.compare(0, body.size(), body) == 0)
+        return true;
+
+    ustring_view error(uchar_str("ERR2\r"), 5);
+    size_t codeLen = std::min<size_t>(body.size(), 3);
+    if (error.compare(0, codeLen, body.substr(0, codeLen)) != 0)
+        return false;
+
+    return body.size() < 4 || (body[3] >= '2' && body[3] <= '7');
+}
+
+CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processUSBInfo(ustring_view data,
         unsigned int pos)
 {
     StateProcResult procResult = { 17, pos, false };
@@ -615,8 +659,8 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processUSBInfo
 }
 
 /* Processes state 21. */
-CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processTRInfo(ustring& data,
-        unsigned int pos)
+CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processTRInfo(ustring_view data,
+        unsigned int pos, const ParseContext& context)
 {
 
     const unsigned int MODULE_DATA_SIZE = 32;
@@ -628,6 +672,45 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processTRInfo(
     if (pos == (data.size() - 1))
         return procResult;
 
+    // frame is delimited regardless of messages following it
+    if (context.expectedType == MSG_TR_INFO) {
+        size_t frameSize = 0;
+        if (context.expectedLength == STANDARD_IDF_SIZE || context.expectedLength == EXTENDED_IDF_SIZE) {
+            if (data.size() >= context.expectedLength) {
+                if (data[context.expectedLength - 1] == 0x0D)
+                    frameSize = context.expectedLength;
+            } else if (data.size() < STANDARD_IDF_SIZE || data[STANDARD_IDF_SIZE - 1] != 0x0D) {
+                return procResult;
+            } else if (data.size() == STANDARD_IDF_SIZE || isFrameStart(data[STANDARD_IDF_SIZE])) {
+                // standard frame of another module, when extended one was expected
+                frameSize = STANDARD_IDF_SIZE;
+            } else {
+                return procResult;
+            }
+        }
+
+        // unknown format - standard frame has to be followed by the next message
+        if (frameSize == 0) {
+            if (data.size() < STANDARD_IDF_SIZE)
+                return procResult;
+
+            bool standardEnd = (data[STANDARD_IDF_SIZE - 1] == 0x0D);
+            if (standardEnd && (data.size() == STANDARD_IDF_SIZE || isFrameStart(data[STANDARD_IDF_SIZE])))
+                frameSize = STANDARD_IDF_SIZE;
+            else if (data.size() < EXTENDED_IDF_SIZE)
+                return procResult;
+            else if (data[EXTENDED_IDF_SIZE - 1] != 0x0D && standardEnd)
+                frameSize = STANDARD_IDF_SIZE;
+            else
+                frameSize = EXTENDED_IDF_SIZE;
+        }
+
+        // bad end of the frame is reported by transition from state 22
+        procResult.newState = 22;
+        procResult.lastPosition = static_cast<unsigned int>(frameSize) - 2;
+        return procResult;
+    }
+
     if (data.size() <= EXTENDED_IDF_SIZE) {
         if (data.size() != STANDARD_IDF_SIZE && data.size() != EXTENDED_IDF_SIZE) {
             return procResult;
@@ -650,7 +733,7 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processTRInfo(
 }
 
 /* Processes state 50. */
-CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processAsynData(ustring& data,
+CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processAsynData(ustring_view data,
         unsigned int pos)
 {
     StateProcResult procResult = { 50, pos, false };
@@ -670,14 +753,50 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processAsynDat
 }
 
 /* Processes state 95. Heuristic - error/upload message or valid download data */
-CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processPMRespData(ustring& data,
-        unsigned int pos)
+CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processPMRespData(ustring_view data,
+        unsigned int pos, const ParseContext& context)
 {
     StateProcResult procResult = { 95, pos, false };
 
     if (pos == (data.size() - 1))
         return procResult;
 
+    // upload is answered by OK, error code or BUSY only
+    if (context.expectedType == MSG_UPLOAD_DOWNLOAD) {
+        procResult.newState = 80;
+        procResult.lastPosition = pos - 1;
+        return procResult;
+    }
+
+    // download data end at expected length, unless an error code came
+    if (context.expectedType == MSG_DOWNLOAD_DATA) {
+        if (isPMErrorCode(data, pos)) {
+            procResult.newState = 80;
+            procResult.lastPosition = pos - 1;
+            return procResult;
+        }
+
+        // split error code must not be taken for short data, the rest
+        // of the data is not scanned for other positions
+        if (isPMErrorCodePrefix(data, pos)) {
+            procResult.lastPosition = static_cast<unsigned int>(data.size()) - 1;
+            return procResult;
+        }
+
+        if (context.expectedLength > pos + 1) {
+            if (data.size() < context.expectedLength) {
+                procResult.lastPosition = static_cast<unsigned int>(data.size()) - 1;
+                return procResult;
+            }
+
+            if (data[context.expectedLength - 1] == 0x0D) {
+                procResult.newState = 96;
+                procResult.lastPosition = context.expectedLength - 2;
+                return procResult;
+            }
+        }
+    }
+
     // Check length of message with error codes
     if (data.size() == 7 || data.size() == 9) {
         // Error message
@@ -697,17 +816,17 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processPMRespD
  * Processes specified special state.
  */
 CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processSpecialState(
-        unsigned int state, ustring& data, unsigned int pos)
+        unsigned int state, ustring_view data, unsigned int pos, const ParseContext& context)
 {
     switch (state) {
     case 17:
         return processUSBInfo(data, pos);
     case 21:
-        return processTRInfo(data, pos);
+        return processTRInfo(data, pos, context);
     case 50:
         return processAsynData(data, pos);
     case 95:
-        return processPMRespData(data, pos);
+        return processPMRespData(data, pos, context);
     }
 
     // error - invalid parser state
@@ -716,18 +835,53 @@ CDCMessageParserPrivate::StateProcResult CDCMessageParserPrivate::processSpecial
     throw CDCMessageParserException((excStream.str()).c_str());
 }
 
-ParseResult CDCMessageParserPrivate::parseData(ustring& data)
+/*
+ * Fast path of DR messages, which form most of received data. The length
+ * byte gives position of terminating 0x0D, so the header is checked and
+ * the data are skipped in constant time. Results are the same as results
+ * of the FSM (states 48 - 52), including NOT_COMPLETE result of message
+ * with 6 bytes received.
+ */
+bool CDCMessageParserPrivate::parseAsyncData(ustring_view data)
+{
+    const size_t DATA_START = 5;
+
+    // incomplete or different header is left to the FSM
+    if (data.size() <= DATA_START || data[0] != '<' || data[1] != 'D'
+            || data[2] != 'R' || data[4] != ':')
+        return false;
+
+    size_t endPos = DATA_START + data[3];
+    if (endPos >= data.size() || data.size() == DATA_START + 1) {
+        lastParseResult.resultType = PARSE_NOT_COMPLETE;
+        lastParseResult.lastPosition = static_cast<unsigned int>(data.size()) - 1;
+        return true;
+    }
+
+    lastParseResult.lastPosition = static_cast<unsigned int>(endPos);
+    if (data[endPos] == 0x0D) {
+        lastParseResult.msgType = MSG_ASYNC;
+        lastParseResult.resultType = PARSE_OK;
+    } else {
+        lastParseResult.resultType = PARSE_BAD_FORMAT;
+    }
+    return true;
+}
+
+ParseResult CDCMessageParserPrivate::parseData(ustring_view data, const ParseContext& context)
 {
-    lastParsedData = data;
+    if (mode == ParserMode::FAST && parseAsyncData(data))
+        return lastParseResult;
+
     lastParseResult.resultType = PARSE_NOT_COMPLETE;
     unsigned int state = INITIAL_STATE;
 
-    for (unsigned int pos = 0; pos < lastParsedData.size(); pos++) {
+    for (unsigned int pos = 0; pos < data.size(); pos++) {
         lastParseResult.lastPosition = pos;
 
         // special handling of some states
         if (isSpecialState(state)) {
-            StateProcResult procResult = processSpecialState(state, lastParsedData, pos);
+            StateProcResult procResult = processSpecialState(state, data, pos, context);
             lastParseResult.lastPosition = procResult.lastPosition;
             if (procResult.formatError) {
                 lastParseResult.resultType = PARSE_BAD_FORMAT;
@@ -749,7 +903,7 @@ ParseResult CDCMessageParserPrivate::parseData(ustring& data)
         }
 
         // do transition to next state
-        state = doTransition(state, lastParsedData[pos]);
+        state = doTransition(state, data[pos]);
         if (state == NO_TRANSITION) {
             lastParseResult.resultType = PARSE_BAD_FORMAT;
             return lastParseResult;
@@ -771,27 +925,32 @@ ParseResult CDCMessageParserPrivate::parseData(ustring& data)
 /* PUBLIC INTERFACE. */
 CDCMessageParser::CDCMessageParser()
 {
-    implObj = ant_new CDCMessageParserPrivate();
+    implObj = ant_new CDCMessageParserPrivate(ParserMode::FAST);
     //InitializeCriticalSection(&csUI);
 }
 
+CDCMessageParser::CDCMessageParser(ParserMode mode)
+{
+    implObj = ant_new CDCMessageParserPrivate(mode);
+}
+
 CDCMessageParser::~CDCMessageParser()
 {
     delete implObj;
     //DeleteCriticalSection(&csUI);
 }
 
-ParseResult CDCMessageParser::parseData(ustring& data)
+ParseResult CDCMessageParser::parseData(ustring_view data, const ParseContext& context)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
-    ParseResult parseResult = implObj->parseData(data);
+    ParseResult parseResult = implObj->parseData(data, context);
 
     //LeaveCriticalSection(&csUI);
     return parseResult;
 }
 
-DeviceInfo* CDCMessageParser::getParsedDeviceInfo(ustring& data)
+DeviceInfo* CDCMessageParser::getParsedDeviceInfo(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
@@ -800,69 +959,113 @@ DeviceInfo* CDCMessageParser::getParsedDeviceInfo(ustring& data)
     // type parsing
     size_t firstHashPos = data.find('#', 3);
     size_t typeSize = firstHashPos - 3;
-    ustring typeStr = data.substr(3, typeSize);
+    ustring_view typeStr = data.substr(3, typeSize);
 
     devInfo->type = ant_new char[typeSize + 1];
     typeStr.copy ((unsigned char*)devInfo->type, typeStr.size()); //strcpy(devInfo->type, (const char*)typeStr.c_str());
+    devInfo->type[typeStr.size()] = '\0';
     devInfo->typeLen = static_cast<unsigned int>(typeSize);
 
     // firmware version parsing
     size_t secondHashPos = data.find('#', firstHashPos+1);
     size_t fmSize = secondHashPos - firstHashPos - 1;
-    ustring fmStr = data.substr(firstHashPos+1, fmSize);
+    ustring_view fmStr = data.substr(firstHashPos+1, fmSize);
 
     devInfo->firmwareVersion = ant_new char[fmSize + 1];
     fmStr.copy ((unsigned char*)devInfo->firmwareVersion, fmStr.size()); //strcpy(devInfo->firmwareVersion, (const char*)fmStr.c_str());
+    devInfo->firmwareVersion[fmStr.size()] = '\0';
     devInfo->fwLen = static_cast<unsigned int>(fmSize);
 
     // serial number parsing
     size_t crPos = data.find(13, secondHashPos+1);
     size_t snSize = crPos - secondHashPos - 1;
-    ustring snStr = data.substr(secondHashPos+1, snSize);
+    ustring_view snStr = data.substr(secondHashPos+1, snSize);
 
     devInfo->serialNumber = ant_new char[snSize + 1];
     snStr.copy ((unsigned char*)devInfo->serialNumber, snStr.size()); //strcpy(devInfo->serialNumber, (const char*)snStr.c_str());
+    devInfo->serialNumber[snStr.size()] = '\0';
     devInfo->snLen = static_cast<unsigned int>(snSize);
 
     //LeaveCriticalSection(&csUI);
     return devInfo;
 }
 
-ModuleInfo* CDCMessageParser::getParsedModuleInfo(ustring& data)
+/*
+* Copies field of I response into inline storage and NUL-terminates it.
+* @return length of stored field
+*/
+static unsigned int copyInfoField(ustring_view data, size_t pos, size_t endPos, char* field)
+{
+    size_t size = (endPos == ustring::npos)? data.size() - pos : endPos - pos;
+    if (size > USBDeviceInfo::FIELD_SIZE - 1)
+        size = USBDeviceInfo::FIELD_SIZE - 1;
+
+    data.copy(reinterpret_cast<unsigned char*>(field), size, pos);
+    field[size] = '\0';
+    return static_cast<unsigned int>(size);
+}
+
+void CDCMessageParser::getParsedDeviceInfo(ustring_view data, USBDeviceInfo& devInfo)
+{
+    std::lock_guard<std::mutex> lck(mtxUI);
+
+    size_t firstHashPos = data.find('#', 3);
+    devInfo.typeLen = copyInfoField(data, 3, firstHashPos, devInfo.type);
+    if (firstHashPos == ustring::npos)
+        firstHashPos = data.size() - 1;
+
+    size_t secondHashPos = data.find('#', firstHashPos+1);
+    devInfo.fwLen = copyInfoField(data, firstHashPos+1, secondHashPos, devInfo.firmwareVersion);
+    if (secondHashPos == ustring::npos)
+        secondHashPos = data.size() - 1;
+
+    size_t crPos = data.find(13, secondHashPos+1);
+    devInfo.snLen = copyInfoField(data, secondHashPos+1, crPos, devInfo.serialNumber);
+}
+
+ModuleInfo* CDCMessageParser::getParsedModuleInfo(ustring_view data)
+{
+    ModuleInfo modInfo;
+    if (!getParsedModuleInfo(data, modInfo))
+        return NULL;
+
+    return ant_new ModuleInfo(modInfo);
+}
+
+bool CDCMessageParser::getParsedModuleInfo(ustring_view data, ModuleInfo& modInfo)
 {
     #define STANDARD_IDF_SIZE   21
     #define EXTENDED_IDF_SIZE   37
 
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
-    // if TR identification data size is wrong, return NULL
+    // if TR identification data size is wrong, return false
     if (data.size() != STANDARD_IDF_SIZE && data.size() != EXTENDED_IDF_SIZE)
-        return NULL;
+        return false;
 
-    ModuleInfo* modInfo = ant_new ModuleInfo();
     size_t msgBodyPos = 4;
 
     // read serial number
-    modInfo->serialNumber[0] = data.at(msgBodyPos);
-    modInfo->serialNumber[1] = data.at(msgBodyPos+1);
-    modInfo->serialNumber[2] = data.at(msgBodyPos+2);
-    modInfo->serialNumber[3] = data.at(msgBodyPos+3);
+    modInfo.serialNumber[0] = data.at(msgBodyPos);
+    modInfo.serialNumber[1] = data.at(msgBodyPos+1);
+    modInfo.serialNumber[2] = data.at(msgBodyPos+2);
+    modInfo.serialNumber[3] = data.at(msgBodyPos+3);
 
     // read OS version
     unsigned int infoId = ModuleInfo::SN_SIZE;
-    modInfo->osVersion = data.at(msgBodyPos+infoId);
+    modInfo.osVersion = data.at(msgBodyPos+infoId);
     infoId++;
     // read TR module type
-    modInfo->trType = data.at(msgBodyPos+infoId);
+    modInfo.trType = data.at(msgBodyPos+infoId);
     infoId++;
 
     // read OS build
     for (unsigned int i = 0; i < ModuleInfo::BUILD_SIZE; i++, infoId++)
-        modInfo->osBuild[i] = data.at(msgBodyPos+infoId);
+        modInfo.osBuild[i] = data.at(msgBodyPos+infoId);
 
     // read reserved area
     for (unsigned int i = 0; i < ModuleInfo::RESERVED_SIZE; i++, infoId++)
-        modInfo->reserved[i] = data.at(msgBodyPos+infoId);
+        modInfo.reserved[i] = data.at(msgBodyPos+infoId);
 
     // check if TR module supports extended idf format
     unsigned int extendedIdfFormat = 0;
@@ -872,16 +1075,16 @@ ModuleInfo* CDCMessageParser::getParsedModuleInfo(ustring& data)
     // read individual bonding key
     for (unsigned int i = 0; i < ModuleInfo::IBK_SIZE; i++, infoId++) {
         if (extendedIdfFormat)
-            modInfo->ibk[i] = data.at(msgBodyPos+infoId);
+            modInfo.ibk[i] = data.at(msgBodyPos+infoId);
         else
-            modInfo->ibk[i] = 0;
+            modInfo.ibk[i] = 0;
     }
 
     //LeaveCriticalSection(&csUI);
-    return modInfo;
+    return true;
 }
 
-SPIStatus CDCMessageParser::getParsedSPIStatus(ustring& data)
+SPIStatus CDCMessageParser::getParsedSPIStatus(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
@@ -904,13 +1107,13 @@ SPIStatus CDCMessageParser::getParsedSPIStatus(ustring& data)
     return spiStatus;
 }
 
-DSResponse CDCMessageParser::getParsedDSResponse(ustring& data)
+DSResponse CDCMessageParser::getParsedDSResponse(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t msgBodyPos = 4;
     size_t bodyLen = data.length() - 1 - msgBodyPos;
-    ustring msgBody = data.substr(msgBodyPos, bodyLen);
+    ustring_view msgBody = data.substr(msgBodyPos, bodyLen);
 
     if (msgBody == uchar_str("OK")) {
         //LeaveCriticalSection(&csUI);
@@ -931,29 +1134,29 @@ DSResponse CDCMessageParser::getParsedDSResponse(ustring& data)
 
     // error - unknown type of response
     std::stringstream excStream;
-    excStream << "Unknown DS response value: " << msgBody.c_str();
+    excStream << "Unknown DS response value: " << ustring(msgBody).c_str();
     throw CDCMessageParserException((excStream.str()).c_str());
 }
 
-ustring CDCMessageParser::getParsedDRData(ustring& data)
+ustring CDCMessageParser::getParsedDRData(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t userDataStart = 5;
     size_t userDataLen = data.length() - 1 - userDataStart;
-    ustring userData = data.substr(5, userDataLen);
+    ustring userData(data.substr(5, userDataLen));
 
     //LeaveCriticalSection(&csUI);
     return userData;
 }
 
-PTEResponse CDCMessageParser::getParsedPEResponse(ustring& data)
+PTEResponse CDCMessageParser::getParsedPEResponse(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t msgBodyPos = 4;
     size_t bodyLen = data.length() - 1 - msgBodyPos;
-    ustring msgBody = data.substr(msgBodyPos, bodyLen);
+    ustring_view msgBody = data.substr(msgBodyPos, bodyLen);
 
     if (msgBody == uchar_str("OK")) {
         //LeaveCriticalSection(&csUI);
@@ -969,17 +1172,17 @@ PTEResponse CDCMessageParser::getParsedPEResponse(ustring& data)
 
     // error - unknown type of response
     std::stringstream excStream;
-    excStream << "Unknown PE response value: " << msgBody.c_str();
+    excStream << "Unknown PE response value: " << ustring(msgBody).c_str();
     throw CDCMessageParserException((excStream.str()).c_str());
 }
 
-PTEResponse CDCMessageParser::getParsedPTResponse(ustring& data)
+PTEResponse CDCMessageParser::getParsedPTResponse(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t msgBodyPos = 4;
     size_t bodyLen = data.length() - 1 - msgBodyPos;
-    ustring msgBody = data.substr(msgBodyPos, bodyLen);
+    ustring_view msgBody = data.substr(msgBodyPos, bodyLen);
 
     if (msgBody == uchar_str("OK")) {
         //LeaveCriticalSection(&csUI);
@@ -995,17 +1198,17 @@ PTEResponse CDCMessageParser::getParsedPTResponse(ustring& data)
 
     // error - unknown type of response
     std::stringstream excStream;
-    excStream << "Unknown PT response value: " << msgBody.c_str();
+    excStream << "Unknown PT response value: " << ustring(msgBody).c_str();
     throw CDCMessageParserException((excStream.str()).c_str());
 }
 
-PMResponse CDCMessageParser::getParsedPMResponse(ustring& data)
+PMResponse CDCMessageParser::getParsedPMResponse(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t msgBodyPos = 4;
     size_t bodyLen = data.length() - 1 - msgBodyPos;
-    ustring msgBody = data.substr(msgBodyPos, bodyLen);
+    ustring_view msgBody = data.substr(msgBodyPos, bodyLen);
 
     if (msgBody == uchar_str("OK")) {
         //LeaveCriticalSection(&csUI);
@@ -1051,17 +1254,17 @@ PMResponse CDCMessageParser::getParsedPMResponse(ustring& data)
 
     // error - unknown type of response
     std::stringstream excStream;
-    excStream << "Unknown PM response value: " << msgBody.c_str();
+    excStream << "Unknown PM response value: " << ustring(msgBody).c_str();
     throw CDCMessageParserException((excStream.str()).c_str());
 }
 
-ustring CDCMessageParser::getParsedPMData(ustring& data)
+ustring CDCMessageParser::getParsedPMData(ustring_view data)
 {
     std::lock_guard<std::mutex> lck(mtxUI);	//EnterCriticalSection(&csUI);
 
     size_t userDataStart = 4;
     size_t userDataLen = data.length() - 1 - userDataStart;
-    ustring userData = data.substr(userDataStart, userDataLen);
+    ustring userData(data.substr(userDataStart, userDataLen));
 
     //LeaveCriticalSection(&csUI);
     return userData;
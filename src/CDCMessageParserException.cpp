@@ -24,5 +24,4 @@ CDCMessageParserException::CDCMessageParserException(const char* cause):CDCImplE
 
 CDCMessageParserException::~CDCMessageParserException() throw()
 {
-    identity.clear();
 }
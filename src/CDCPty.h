@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+/*
+ * Pseudo-terminals used in place of the port of USB device.
+ * Both functions throw CDCImplException on failure.
+ */
+
+/* Creates pseudo-terminal in raw mode, returns its master side and name of its slave side. */
+int openPtyMaster(std::string& slaveName);
+
+/* Opens slave side of pseudo-terminal in raw mode. */
+int openPtySlave(const std::string& slaveName);
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <CDCPty.h>
+#include <CDCImplException.h>
+
+/* Bytes must pass through the pseudo-terminal unchanged. */
+static void setRawMode(int fd)
+{
+    struct termios ptyOptions;
+    if (tcgetattr(fd, &ptyOptions) == -1)
+        THROW_EXCEPT(CDCImplException, "Pseudo-terminal parameters getting failed with error " << errno);
+
+    cfmakeraw(&ptyOptions);
+    ptyOptions.c_cc[VMIN] = 1;
+    ptyOptions.c_cc[VTIME] = 0;
+
+    if (tcsetattr(fd, TCSANOW, &ptyOptions) == -1)
+        THROW_EXCEPT(CDCImplException, "Pseudo-terminal parameters setting failed with error " << errno);
+}
+
+int openPtyMaster(std::string& slaveName)
+{
+    int masterHandle = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterHandle == -1)
+        THROW_EXCEPT(CDCImplException, "Pseudo-terminal creation failed with error " << errno);
+
+    try {
+        char nameBuffer[128];
+        if (grantpt(masterHandle) != 0 || unlockpt(masterHandle) != 0
+                || ptsname_r(masterHandle, nameBuffer, sizeof(nameBuffer)) != 0)
+            THROW_EXCEPT(CDCImplException, "Pseudo-terminal unlocking failed with error " << errno);
+
+        setRawMode(masterHandle);
+        slaveName = nameBuffer;
+    }
+    catch (CDCImplException&) {
+        close(masterHandle);
+        throw;
+    }
+
+    return masterHandle;
+}
+
+int openPtySlave(const std::string& slaveName)
+{
+    int slaveHandle = open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+    if (slaveHandle == -1)
+        THROW_EXCEPT(CDCImplException, "Pseudo-terminal opening failed with error " << errno);
+
+    try {
+        setRawMode(slaveHandle);
+    }
+    catch (CDCImplException&) {
+        close(slaveHandle);
+        throw;
+    }
+
+    return slaveHandle;
+}
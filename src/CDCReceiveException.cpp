@@ -24,5 +24,4 @@ CDCReceiveException::CDCReceiveException(const char* cause):CDCImplException(cau
 
 CDCReceiveException::~CDCReceiveException() throw()
 {
-    identity.clear();
 }
@@ -0,0 +1,303 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/eventfd.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <CDCReplay.h>
+#include <CDCCapture.h>
+#include <CDCImplException.h>
+#include <CDCTransport.h>
+#include <CDCPty.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/*
+ * Implementation class.
+ */
+class CDCReplayPrivate {
+public:
+    CDCReplayPrivate(const char* captureFile, ReplaySpeed speed);
+    ~CDCReplayPrivate();
+
+    /* Waiting for transmitted data of one record. */
+    static constexpr unsigned int TM_WAIT_TX = 5;
+
+    /* Records of the capture file. */
+    std::vector<CaptureRecord> records;
+
+    ReplaySpeed speed;
+
+    /* Master side of pseudo-terminal. */
+    int masterHandle;
+    std::string portName;
+
+    /* Signal for replay thread to cancel. */
+    int stopEvent;
+
+    std::thread replayHandle;
+
+    /* Transmitted data read from pseudo-terminal, but not verified yet. */
+    ustring pendingTx;
+
+    ReplayStats stats;
+    std::string lastError;
+    bool ended;
+    std::mutex csState;
+    std::condition_variable endCondition;
+
+    /* Function of replay thread. */
+    void replayThread();
+
+    /* Writes received data of record into pseudo-terminal. */
+    void replayRx(const ustring& data);
+
+    /* Reads transmitted data from pseudo-terminal and compares them to the record. */
+    void verifyTx(const ustring& data);
+
+    /*
+     * Waits until specified time. Transmitted data coming in the meantime
+     * are appended to pendingTx. Throws ReplayCancelled if the replay
+     * was cancelled.
+     */
+    void waitUntil(std::chrono::steady_clock::time_point deadline);
+
+    void setLastError(const std::string& descr);
+};
+
+/* Thrown inside replay thread, when the replay is cancelled. */
+struct ReplayCancelled {};
+
+CDCReplayPrivate::CDCReplayPrivate(const char* captureFile, ReplaySpeed speed)
+    :speed(speed), masterHandle(-1), stopEvent(-1), stats(), ended(false)
+{
+    CDCCaptureReader reader(captureFile);
+    CaptureRecord record;
+    while (reader.next(record))
+        records.push_back(record);
+
+    masterHandle = openPtyMaster(portName);
+
+    stopEvent = eventfd(0, 0);
+    if (stopEvent == -1) {
+        int err = errno;
+        close(masterHandle);
+        THROW_EXCEPT(CDCImplException, "Create stop event failed with error " << err);
+    }
+}
+
+CDCReplayPrivate::~CDCReplayPrivate()
+{
+    uint64_t stopData = 1;
+    ssize_t ret = write(stopEvent, &stopData, sizeof(stopData));
+    (void)ret; //the thread may have already ended
+
+    if (replayHandle.joinable())
+        replayHandle.join();
+
+    close(stopEvent);
+    close(masterHandle);
+}
+
+void CDCReplayPrivate::setLastError(const std::string& descr)
+{
+    std::lock_guard<std::mutex> lck(csState);
+    if (lastError.empty())
+        lastError = descr;
+}
+
+void CDCReplayPrivate::waitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    unsigned char buffer[1024];
+    int maxEventNum = ((masterHandle > stopEvent)? masterHandle:stopEvent) + 1;
+
+    while (true) {
+        long long timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (timeout <= 0)
+            return;
+
+        fd_set waitEvents;
+        FD_ZERO(&waitEvents);
+        FD_SET(masterHandle, &waitEvents);
+        FD_SET(stopEvent, &waitEvents);
+
+        struct timeval waitTime;
+        waitTime.tv_sec = timeout / 1000000;
+        waitTime.tv_usec = timeout % 1000000;
+
+        int waitResult = select(maxEventNum, &waitEvents, NULL, NULL, &waitTime);
+        if (waitResult == -1)
+            THROW_EXCEPT(CDCImplException, "Waiting for replay event failed with error " << errno);
+
+        if (FD_ISSET(stopEvent, &waitEvents))
+            throw ReplayCancelled();
+
+        if (FD_ISSET(masterHandle, &waitEvents)) {
+            ssize_t readResult = read(masterHandle, buffer, sizeof(buffer));
+            if (readResult == -1)
+                THROW_EXCEPT(CDCImplException, "Reading of transmitted data failed with error " << errno);
+            pendingTx.append(buffer, readResult);
+            return;
+        }
+    }
+}
+
+void CDCReplayPrivate::replayRx(const ustring& data)
+{
+    const unsigned char* dataToWrite = data.data();
+    size_t dataLen = data.size();
+
+    while (dataLen > 0) {
+        ssize_t writeResult = write(masterHandle, dataToWrite, dataLen);
+        if (writeResult == -1)
+            THROW_EXCEPT(CDCImplException, "Replay of received data failed with error " << errno);
+
+        dataLen -= writeResult;
+        dataToWrite += writeResult;
+    }
+
+    std::lock_guard<std::mutex> lck(csState);
+    stats.rxRecords++;
+    stats.rxBytes += data.size();
+}
+
+void CDCReplayPrivate::verifyTx(const ustring& data)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(TM_WAIT_TX);
+
+    while (pendingTx.size() < data.size()) {
+        if (std::chrono::steady_clock::now() >= deadline)
+            THROW_EXCEPT(CDCImplException, "Waiting for transmitted record "
+                << stats.txRecords << " timeouted");
+
+        waitUntil(deadline);
+    }
+
+    bool match = (pendingTx.compare(0, data.size(), data) == 0);
+    pendingTx.erase(0, data.size());
+
+    if (!match) {
+        std::ostringstream msg;
+        msg << "Transmitted record " << stats.txRecords << " differs from capture";
+        setLastError(msg.str());
+    }
+
+    std::lock_guard<std::mutex> lck(csState);
+    stats.txRecords++;
+    stats.txBytes += data.size();
+    if (!match)
+        stats.txMismatches++;
+}
+
+void CDCReplayPrivate::replayThread()
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    // last point of synchronization between the capture and the replay
+    auto syncTime = startTime;
+    unsigned long long syncTimestamp = records.empty()? 0 : records.front().timestamp;
+
+    try {
+        for (const CaptureRecord& record : records) {
+            if (record.direction == CAPTURE_TX) {
+                verifyTx(record.data);
+                syncTime = std::chrono::steady_clock::now();
+                syncTimestamp = record.timestamp;
+                continue;
+            }
+
+            if (speed == ReplaySpeed::RECORDED && record.timestamp > syncTimestamp) {
+                auto replayTime = syncTime + std::chrono::microseconds(record.timestamp - syncTimestamp);
+                while (std::chrono::steady_clock::now() < replayTime)
+                    waitUntil(replayTime);
+            }
+
+            replayRx(record.data);
+        }
+    }
+    catch (ReplayCancelled&) {
+        setLastError("Replay cancelled");
+    }
+    catch (CDCImplException& e) {
+        setLastError(e.what());
+    }
+
+    std::lock_guard<std::mutex> lck(csState);
+    stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    ended = true;
+    endCondition.notify_all();
+}
+
+/* --- PUBLIC INTERFACE */
+CDCReplay::CDCReplay(const char* captureFile, ReplaySpeed speed)
+{
+    implObj = ant_new CDCReplayPrivate(captureFile, speed);
+}
+
+CDCReplay::~CDCReplay()
+{
+    delete implObj;
+}
+
+const char* CDCReplay::getPortName(void)
+{
+    return implObj->portName.c_str();
+}
+
+CDCTransport* CDCReplay::createTransport(void)
+{
+    return ant_new CDCFdTransport(openPtySlave(implObj->portName));
+}
+
+void CDCReplay::start(void)
+{
+    if (implObj->replayHandle.joinable())
+        THROW_EXCEPT(CDCImplException, "Replay has been already started");
+
+    implObj->replayHandle = std::thread(&CDCReplayPrivate::replayThread, implObj);
+}
+
+bool CDCReplay::waitForEnd(unsigned int timeout)
+{
+    std::unique_lock<std::mutex> lck(implObj->csState);
+    if (timeout == 0) {
+        implObj->endCondition.wait(lck, [this] { return implObj->ended; });
+        return true;
+    }
+
+    return implObj->endCondition.wait_for(lck, std::chrono::milliseconds(timeout),
+        [this] { return implObj->ended; });
+}
+
+ReplayStats CDCReplay::getStats(void)
+{
+    std::lock_guard<std::mutex> lck(implObj->csState);
+    return implObj->stats;
+}
+
+std::string CDCReplay::getLastError(void)
+{
+    std::lock_guard<std::mutex> lck(implObj->csState);
+    return implObj->lastError;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CDCResult.h>
+#include <sstream>
+
+const char* getErrorCodeDescr(CDCErrorCode code) noexcept
+{
+    switch (code) {
+    case CDCErrorCode::OK:
+        return "OK";
+    case CDCErrorCode::RECEPTION_STOPPED:
+        return "Reading is actually stopped";
+    case CDCErrorCode::INVALID_ARGUMENT:
+        return "Invalid argument";
+    case CDCErrorCode::DATA_TOO_LARGE:
+        return "Data size too large";
+    case CDCErrorCode::SEND_TIMEOUT:
+        return "Waiting for send timeouted";
+    case CDCErrorCode::SEND_FAILED:
+        return "Sending message failed";
+    case CDCErrorCode::RESPONSE_TIMEOUT:
+        return "Waiting for event timeout";
+    case CDCErrorCode::RECEIVE_FAILED:
+        return "Waiting for response failed";
+    case CDCErrorCode::BAD_RESPONSE:
+        return "Response has bad type";
+    case CDCErrorCode::STATUS_UNKNOWN:
+        return "SPI status is not known yet";
+    case CDCErrorCode::DEVICE_DISCONNECTED:
+        return "Device is disconnected";
+    case CDCErrorCode::INTERNAL_ERROR:
+        return "Internal error";
+    }
+    return "Unknown error";
+}
+
+std::string CDCStatus::message(void) const
+{
+    if (sysError == 0)
+        return getErrorCodeDescr(code);
+
+    std::ostringstream ostr;
+    ostr << getErrorCodeDescr(code) << " with error " << sysError;
+    return ostr.str();
+}
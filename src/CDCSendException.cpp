@@ -24,5 +24,4 @@ CDCSendException::CDCSendException(const char* cause):CDCImplException(cause)
 
 CDCSendException::~CDCSendException() throw()
 {
-    identity.clear();
 }
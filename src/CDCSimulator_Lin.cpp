@@ -0,0 +1,441 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/eventfd.h>
+#include <sys/select.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <CDCSimulator.h>
+#include <CDCImplException.h>
+#include <CDCTypes.h>
+#include <CDCPty.h>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <climits>
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+/*
+ * Implementation class.
+ */
+class CDCSimulatorPrivate {
+public:
+    CDCSimulatorPrivate(const SimulatorOptions& options);
+    ~CDCSimulatorPrivate();
+
+    /* Response scheduled for sending. */
+    struct ScheduledOutput {
+        TimePoint time;
+        ustring data;
+    };
+
+    /* Maximal amount of unread data - then generated DR messages are dropped. */
+    static const size_t OUTPUT_LIMIT = 65536;
+
+    SimulatorOptions options;
+    SimulatorStats stats;
+    std::mutex csState;
+
+    /* Master side of pseudo-terminal. */
+    int masterHandle;
+
+    /* Slave side of pseudo-terminal, kept open to avoid hang-ups of master side. */
+    int slaveHandle;
+    std::string portName;
+
+    /* Signal for device thread to cancel. */
+    int stopEvent;
+
+    std::thread deviceHandle;
+
+    /* Received, not yet processed commands. */
+    ustring inputBuffer;
+
+    /* Responses waiting for their latency to elapse. */
+    std::deque<ScheduledOutput> scheduledOutputs;
+
+    /* Data waiting for the pseudo-terminal to become writable. */
+    ustring outputBuffer;
+
+    /* Time of next generated DR message. */
+    TimePoint nextAsync;
+
+    /* Function of device thread. */
+    void deviceThread();
+
+    /* Extracts and processes all complete commands in input buffer. */
+    void processCommands();
+
+    /* Returns response to specified command. */
+    ustring respond(const ustring& cmd, const SimulatorOptions& currOptions);
+
+    /* Returns DR message with specified data. */
+    ustring asyncMessage(const ustring& data);
+
+    /* Writes as much of output buffer as possible. */
+    void flushOutput();
+
+    SimulatorOptions getOptions();
+};
+
+/*
+ * For converting string literals to unsigned string literals.
+ */
+inline const unsigned char* uchar_str(const char* s)
+{
+    return reinterpret_cast<const unsigned char*>(s);
+}
+
+CDCSimulatorPrivate::CDCSimulatorPrivate(const SimulatorOptions& options)
+    :options(options), stats(), masterHandle(-1), slaveHandle(-1), stopEvent(-1)
+{
+    masterHandle = openPtyMaster(portName);
+
+    try {
+        slaveHandle = openPtySlave(portName);
+
+        // writing must not block the device thread, if nobody reads
+        int flags = fcntl(masterHandle, F_GETFL);
+        if (flags == -1 || fcntl(masterHandle, F_SETFL, flags | O_NONBLOCK) == -1)
+            THROW_EXCEPT(CDCImplException, "Pseudo-terminal setting failed with error " << errno);
+
+        stopEvent = eventfd(0, 0);
+        if (stopEvent == -1)
+            THROW_EXCEPT(CDCImplException, "Create stop event failed with error " << errno);
+    }
+    catch (CDCImplException&) {
+        if (slaveHandle != -1)
+            close(slaveHandle);
+        close(masterHandle);
+        throw;
+    }
+
+    nextAsync = std::chrono::steady_clock::now();
+    deviceHandle = std::thread(&CDCSimulatorPrivate::deviceThread, this);
+}
+
+CDCSimulatorPrivate::~CDCSimulatorPrivate()
+{
+    uint64_t stopData = 1;
+    ssize_t ret = write(stopEvent, &stopData, sizeof(stopData));
+    (void)ret; //the thread may have already ended
+
+    if (deviceHandle.joinable())
+        deviceHandle.join();
+
+    close(stopEvent);
+    close(slaveHandle);
+    close(masterHandle);
+}
+
+SimulatorOptions CDCSimulatorPrivate::getOptions()
+{
+    std::lock_guard<std::mutex> lck(csState);
+    return options;
+}
+
+ustring CDCSimulatorPrivate::asyncMessage(const ustring& data)
+{
+    ustring msg(uchar_str("<DR"));
+    msg.append(1, static_cast<unsigned char>(data.size()));
+    msg.append(1, ':');
+    msg.append(data);
+    msg.append(1, 0x0D);
+    return msg;
+}
+
+ustring CDCSimulatorPrivate::respond(const ustring& cmd, const SimulatorOptions& currOptions)
+{
+    // command without leading '>' and trailing CR
+    ustring header = cmd.substr(1, cmd.size() - 2);
+
+    if (header.empty())
+        return uchar_str("<OK\r");
+
+    if (header.compare(0, 2, uchar_str("DS")) == 0) {
+        switch (currOptions.dsResponse) {
+        case ERR:
+            return uchar_str("<DS:ERR\r");
+        case BUSY:
+            return uchar_str("<DS:BUSY\r");
+        default:
+            break;
+        }
+
+        ustring response(uchar_str("<DS:OK\r"));
+
+        // DPA response - NADR, PNUM, PCMD with response flag, HWPID, ErrN, DpaValue
+        ustring request = header.substr(4);
+        if (currOptions.dpaResponses && request.size() >= 6) {
+            ustring dpaResponse = request.substr(0, 6);
+            dpaResponse[3] |= 0x80;
+            dpaResponse.append(1, 0x00);
+            dpaResponse.append(1, 0x40);
+            response.append(asyncMessage(dpaResponse));
+        }
+        return response;
+    }
+
+    if (header.compare(0, 2, uchar_str("PM")) == 0) {
+        // upload is confirmed, download returns data
+        if (header.size() < 3 || (header[2] & 0x80) != 0)
+            return uchar_str("<PM:OK\r");
+
+        // configuration of RFPGM and RF band is one byte, memory blocks are 32 bytes
+        unsigned char dataSize = (header[2] == 0x01 || header[2] == 0x02)? 1 : 32;
+        ustring response(uchar_str("<PM:"));
+        for (unsigned char i = 0; i < dataSize; i++)
+            response.append(1, i);
+        response.append(1, 0x0D);
+        return response;
+    }
+
+    if (header == uchar_str("S")) {
+        ustring response(uchar_str("<S:"));
+        response.append(1, static_cast<unsigned char>(currOptions.spiMode));
+        response.append(1, 0x0D);
+        return response;
+    }
+
+    if (header == uchar_str("I"))
+        return uchar_str("<I:GW-USB-SIM#01.00#0123ABCD\r");
+
+    if (header == uchar_str("IT")) {
+        // serial number, OS version, TR type, OS build, reserved, IBK
+        const unsigned char moduleData[] = {
+            0x01, 0x02, 0x03, 0x81, 0x43, 0x24, 0xD0, 0x08,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+        };
+        ustring response(uchar_str("<IT:"));
+        response.append(moduleData, sizeof(moduleData));
+        response.append(1, 0x0D);
+        return response;
+    }
+
+    const char* okCommands[] = { "R", "RT", "B", "U", "PE", "PT" };
+    for (const char* okCommand : okCommands) {
+        if (header == uchar_str(okCommand)) {
+            ustring response(uchar_str("<"));
+            response.append(header);
+            response.append(uchar_str(":OK\r"));
+            return response;
+        }
+    }
+
+    return uchar_str("<ERR\r");
+}
+
+void CDCSimulatorPrivate::processCommands()
+{
+    SimulatorOptions currOptions = getOptions();
+
+    while (!inputBuffer.empty()) {
+        // skip garbage before start of command
+        size_t startPos = inputBuffer.find('>');
+        if (startPos == ustring::npos) {
+            inputBuffer.clear();
+            return;
+        }
+        inputBuffer.erase(0, startPos);
+
+        size_t endPos = ustring::npos;
+        if (inputBuffer.compare(0, 3, uchar_str(">DS")) == 0) {
+            // data length is known
+            if (inputBuffer.size() < 5)
+                return;
+            endPos = 5 + inputBuffer[3];
+            if (inputBuffer.size() <= endPos)
+                return;
+        } else if (inputBuffer.compare(0, 3, uchar_str(">PM")) == 0) {
+            // PM data may contain CR and have no length - CDCImpl sends
+            // only one command at a time, so take all received data
+            endPos = inputBuffer.rfind(0x0D);
+        } else {
+            endPos = inputBuffer.find(0x0D);
+        }
+
+        if (endPos == ustring::npos)
+            return;
+
+        ustring cmd = inputBuffer.substr(0, endPos + 1);
+        inputBuffer.erase(0, endPos + 1);
+
+        ScheduledOutput output;
+        output.time = std::chrono::steady_clock::now() + std::chrono::microseconds(currOptions.responseLatency);
+        output.data = respond(cmd, currOptions);
+        scheduledOutputs.push_back(output);
+
+        std::lock_guard<std::mutex> lck(csState);
+        stats.commands++;
+    }
+}
+
+void CDCSimulatorPrivate::flushOutput()
+{
+    while (!outputBuffer.empty()) {
+        ssize_t writeResult = write(masterHandle, outputBuffer.data(), outputBuffer.size());
+        if (writeResult == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            THROW_EXCEPT(CDCImplException, "Writing to pseudo-terminal failed with error " << errno);
+        }
+
+        outputBuffer.erase(0, writeResult);
+
+        std::lock_guard<std::mutex> lck(csState);
+        stats.txBytes += writeResult;
+    }
+}
+
+void CDCSimulatorPrivate::deviceThread()
+{
+    unsigned char buffer[1024];
+    int maxEventNum = ((masterHandle > stopEvent)? masterHandle:stopEvent) + 1;
+
+    try {
+        while (true) {
+            SimulatorOptions currOptions = getOptions();
+            TimePoint now = std::chrono::steady_clock::now();
+
+            // send responses, whose latency has elapsed
+            while (!scheduledOutputs.empty() && scheduledOutputs.front().time <= now) {
+                outputBuffer.append(scheduledOutputs.front().data);
+                scheduledOutputs.pop_front();
+            }
+
+            // generate asynchronous traffic
+            if (currOptions.asyncRate == 0) {
+                nextAsync = now;
+            } else {
+                std::chrono::microseconds asyncPeriod(1000000 / currOptions.asyncRate);
+                while (nextAsync <= now) {
+                    ustring data;
+                    for (unsigned int i = 0; i < currOptions.asyncLength && i < UCHAR_MAX; i++)
+                        data.append(1, static_cast<unsigned char>(i));
+
+                    std::lock_guard<std::mutex> lck(csState);
+                    if (outputBuffer.size() < OUTPUT_LIMIT) {
+                        ustring message = asyncMessage(data);
+                        stats.asyncMessages++;
+
+                        // noise on the line - header, length byte or end of message
+                        if (currOptions.corruptInterval != 0 && stats.asyncMessages % currOptions.corruptInterval == 0) {
+                            size_t positions[] = { 0, 1, 2, 3, 4, message.size() - 1 };
+                            size_t corrupted = (stats.corruptedMessages++) % (sizeof(positions) / sizeof(positions[0]));
+                            message[positions[corrupted]] ^= 0x55;
+                        }
+                        outputBuffer.append(message);
+                    } else {
+                        stats.droppedMessages++;
+                    }
+                    nextAsync += asyncPeriod;
+                }
+            }
+
+            flushOutput();
+
+            // wait for next command, next scheduled event or writability
+            TimePoint wakeUp = now + std::chrono::seconds(1);
+            if (!scheduledOutputs.empty() && scheduledOutputs.front().time < wakeUp)
+                wakeUp = scheduledOutputs.front().time;
+            if (currOptions.asyncRate != 0 && nextAsync < wakeUp)
+                wakeUp = nextAsync;
+
+            long long timeout = std::chrono::duration_cast<std::chrono::microseconds>(
+                wakeUp - std::chrono::steady_clock::now()).count();
+            if (timeout < 0)
+                timeout = 0;
+
+            struct timeval waitTime;
+            waitTime.tv_sec = timeout / 1000000;
+            waitTime.tv_usec = timeout % 1000000;
+
+            fd_set readEvents;
+            FD_ZERO(&readEvents);
+            FD_SET(masterHandle, &readEvents);
+            FD_SET(stopEvent, &readEvents);
+
+            fd_set writeEvents;
+            FD_ZERO(&writeEvents);
+            if (!outputBuffer.empty())
+                FD_SET(masterHandle, &writeEvents);
+
+            int waitResult = select(maxEventNum, &readEvents, &writeEvents, NULL, &waitTime);
+            if (waitResult == -1)
+                THROW_EXCEPT(CDCImplException, "Waiting for simulator event failed with error " << errno);
+
+            if (FD_ISSET(stopEvent, &readEvents))
+                break;
+
+            if (FD_ISSET(masterHandle, &readEvents)) {
+                ssize_t readResult = read(masterHandle, buffer, sizeof(buffer));
+                if (readResult == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+                    THROW_EXCEPT(CDCImplException, "Reading from pseudo-terminal failed with error " << errno);
+
+                if (readResult > 0) {
+                    inputBuffer.append(buffer, readResult);
+                    {
+                        std::lock_guard<std::mutex> lck(csState);
+                        stats.rxBytes += readResult;
+                    }
+                    processCommands();
+                }
+            }
+        }
+    }
+    catch (CDCImplException&) {
+        // simulated device is unplugged
+    }
+}
+
+/* --- PUBLIC INTERFACE */
+CDCSimulator::CDCSimulator(const SimulatorOptions& options)
+{
+    implObj = ant_new CDCSimulatorPrivate(options);
+}
+
+CDCSimulator::~CDCSimulator()
+{
+    delete implObj;
+}
+
+const char* CDCSimulator::getPortName(void)
+{
+    return implObj->portName.c_str();
+}
+
+CDCTransport* CDCSimulator::createTransport(void)
+{
+    return ant_new CDCFdTransport(openPtySlave(implObj->portName));
+}
+
+void CDCSimulator::setOptions(const SimulatorOptions& options)
+{
+    std::lock_guard<std::mutex> lck(implObj->csState);
+    implObj->options = options;
+}
+
+SimulatorStats CDCSimulator::getStats(void)
+{
+    std::lock_guard<std::mutex> lck(implObj->csState);
+    return implObj->stats;
+}
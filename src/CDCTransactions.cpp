@@ -0,0 +1,445 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CDCTransactions.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/* Length of DPA request header - NADR, PNUM, PCMD, HWPID. */
+static const size_t DPA_REQUEST_HEADER = 6;
+
+/* Position of ErrN in DPA response and confirmation. */
+static const size_t DPA_ERRN_POS = 6;
+
+/* PCMD flag of DPA response. */
+static const unsigned char DPA_RESPONSE_FLAG = 0x80;
+
+/* ErrN of DPA confirmation. */
+static const unsigned char DPA_STATUS_CONFIRMATION = 0xFF;
+
+/* NADR of broadcast. */
+static const unsigned int DPA_BROADCAST_ADDRESS = 0xFF;
+
+/*
+ * Implementation class.
+ */
+class CDCTransactionsPrivate {
+public:
+    CDCTransactionsPrivate(CDCImpl& cdc, unsigned int tickInterval);
+    ~CDCTransactionsPrivate();
+
+    /* Pending transaction, linked into pending table and timer wheel. */
+    struct Transaction {
+        unsigned long long id;
+        uint32_t key;
+        bool broadcast;
+        unsigned long long deadlineTick;
+        TransactionResult result;
+        TransactionCallbackF callback;
+
+        // next transaction with the same key
+        Transaction* keyNext;
+
+        // neighbours in slot of timer wheel
+        Transaction* wheelPrev;
+        Transaction* wheelNext;
+    };
+
+    /* Number of slots of timer wheel, power of 2. */
+    static const unsigned int WHEEL_SIZE = 512;
+
+    CDCImpl& cdc;
+
+    /* Duration of one tick of timer wheel. */
+    std::chrono::milliseconds tickInterval;
+    Clock::time_point startTime;
+
+    /* Pending transactions - the oldest one with each key. */
+    std::unordered_map<uint32_t, Transaction*> pendingTable;
+    unsigned int pendingCount;
+    unsigned long long nextId;
+
+    /* Slots of timer wheel and the last processed tick. */
+    std::vector<Transaction*> wheel;
+    unsigned long long processedTick;
+
+    std::mutex csTransactions;
+    std::condition_variable timerCond;
+    bool timerRunning;
+    std::thread timerHandle;
+
+    /* Identifier of listener registered in CDCImpl. */
+    unsigned int listenerId;
+
+    AsyncMsgListenerF unmatchedListener;
+    std::mutex csUnmatchedListener;
+
+    /* Returns key of DPA request or response. */
+    static uint32_t messageKey(const unsigned char* data);
+
+    /* Returns current tick of timer wheel. */
+    unsigned long long currentTick(void);
+
+    /* Registers new transaction and returns its ID. */
+    unsigned long long addTransaction(const ustring& request, unsigned int timeout,
+        TransactionCallbackF callback);
+
+    /* Unlinks transaction from pending table and timer wheel. */
+    void removeTransaction(Transaction* transaction);
+
+    /* Finishes transaction, which failed to be sent. */
+    void failTransaction(uint32_t key, unsigned long long id, const CDCStatus& sendStatus,
+        DSResponse dsResponse);
+
+    /* Matches DR message with pending transaction. */
+    void processAsyncMessage(unsigned char* data, unsigned int length);
+
+    /* Function of timer thread. */
+    void timerThread(void);
+
+    /* Calls callbacks of finished transactions and deletes them. */
+    void finishTransactions(std::vector<Transaction*>& finished);
+};
+
+CDCTransactionsPrivate::CDCTransactionsPrivate(CDCImpl& cdc, unsigned int tickInterval)
+  :cdc(cdc), tickInterval((tickInterval == 0)? 1 : tickInterval), pendingCount(0), nextId(0),
+    wheel(WHEEL_SIZE, NULL), processedTick(0), timerRunning(true), listenerId(0)
+{
+    startTime = Clock::now();
+    timerHandle = std::thread(&CDCTransactionsPrivate::timerThread, this);
+}
+
+CDCTransactionsPrivate::~CDCTransactionsPrivate()
+{
+    std::vector<Transaction*> aborted;
+    {
+        std::lock_guard<std::mutex> lck(csTransactions);
+        timerRunning = false;
+
+        for (auto& pending : pendingTable) {
+            for (Transaction* transaction = pending.second; transaction != NULL; transaction = transaction->keyNext) {
+                transaction->result.status = TransactionStatus::ABORTED;
+                aborted.push_back(transaction);
+            }
+        }
+        pendingTable.clear();
+        pendingCount = 0;
+    }
+    timerCond.notify_one();
+
+    if (timerHandle.joinable())
+        timerHandle.join();
+
+    finishTransactions(aborted);
+}
+
+uint32_t CDCTransactionsPrivate::messageKey(const unsigned char* data)
+{
+    uint32_t nadr = data[0] | (data[1] << 8);
+    uint32_t pnum = data[2];
+    uint32_t pcmd = data[3] & ~DPA_RESPONSE_FLAG;
+    return (nadr << 16) | (pnum << 8) | pcmd;
+}
+
+unsigned long long CDCTransactionsPrivate::currentTick(void)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime).count()
+        / tickInterval.count();
+}
+
+/*
+ * Registers transaction into pending table and into slot of its deadline.
+ * The transaction is registered before sending, as the response can come
+ * before DS response is processed.
+ */
+unsigned long long CDCTransactionsPrivate::addTransaction(const ustring& request, unsigned int timeout,
+    TransactionCallbackF callback)
+{
+    Transaction* transaction = ant_new Transaction();
+    transaction->key = messageKey(request.data());
+    transaction->broadcast = ((request[0] | (request[1] << 8)) == DPA_BROADCAST_ADDRESS);
+    transaction->callback = callback;
+    transaction->keyNext = NULL;
+    transaction->wheelPrev = NULL;
+
+    // deadline is rounded up to whole ticks
+    unsigned long long ticks = (timeout + tickInterval.count() - 1) / tickInterval.count();
+
+    bool firstPending = false;
+    {
+        std::lock_guard<std::mutex> lck(csTransactions);
+        transaction->id = nextId++;
+
+        // ticks without transactions need not be processed, the deadline
+        // must not be in a slot the timer thread has already passed
+        if (pendingCount == 0)
+            processedTick = currentTick();
+        transaction->deadlineTick = std::max(currentTick() + ticks + 1, processedTick + 1);
+
+        // transactions with the same key are matched in order of sending
+        Transaction*& pending = pendingTable[transaction->key];
+        Transaction** last = &pending;
+        while (*last != NULL)
+            last = &(*last)->keyNext;
+        *last = transaction;
+
+        Transaction*& slot = wheel[transaction->deadlineTick & (WHEEL_SIZE - 1)];
+        transaction->wheelNext = slot;
+        if (slot != NULL)
+            slot->wheelPrev = transaction;
+        slot = transaction;
+
+        firstPending = (pendingCount++ == 0);
+    }
+
+    // timer thread sleeps without pending transactions
+    if (firstPending)
+        timerCond.notify_one();
+
+    return transaction->id;
+}
+
+/*
+ * Unlinks transaction from pending table and timer wheel. Must be called
+ * with locked csTransactions.
+ */
+void CDCTransactionsPrivate::removeTransaction(Transaction* transaction)
+{
+    auto pending = pendingTable.find(transaction->key);
+    Transaction** link = &pending->second;
+    while (*link != transaction)
+        link = &(*link)->keyNext;
+    *link = transaction->keyNext;
+    if (pending->second == NULL)
+        pendingTable.erase(pending);
+
+    if (transaction->wheelPrev != NULL)
+        transaction->wheelPrev->wheelNext = transaction->wheelNext;
+    else
+        wheel[transaction->deadlineTick & (WHEEL_SIZE - 1)] = transaction->wheelNext;
+    if (transaction->wheelNext != NULL)
+        transaction->wheelNext->wheelPrev = transaction->wheelPrev;
+
+    pendingCount--;
+}
+
+/*
+ * Finishes transaction, which was not accepted by DS command, if it
+ * is still pending.
+ */
+void CDCTransactionsPrivate::failTransaction(uint32_t key, unsigned long long id, const CDCStatus& sendStatus,
+    DSResponse dsResponse)
+{
+    std::vector<Transaction*> finished;
+    {
+        std::lock_guard<std::mutex> lck(csTransactions);
+        auto pending = pendingTable.find(key);
+        if (pending == pendingTable.end())
+            return;
+
+        Transaction* transaction = pending->second;
+        while (transaction != NULL && transaction->id != id)
+            transaction = transaction->keyNext;
+        if (transaction == NULL)
+            return;
+
+        removeTransaction(transaction);
+        transaction->result.status = TransactionStatus::SEND_FAILED;
+        transaction->result.sendStatus = sendStatus;
+        transaction->result.dsResponse = dsResponse;
+        finished.push_back(transaction);
+    }
+    finishTransactions(finished);
+}
+
+/*
+ * Matches DR message with the oldest pending transaction with the same key.
+ * Confirmation is only stored, unless the request was broadcast.
+ */
+void CDCTransactionsPrivate::processAsyncMessage(unsigned char* data, unsigned int length)
+{
+    if (data == NULL || length < DPA_REQUEST_HEADER) {
+        std::lock_guard<std::mutex> lck(csUnmatchedListener);
+        if (unmatchedListener)
+            unmatchedListener(data, length);
+        return;
+    }
+
+    bool isResponse = (data[3] & DPA_RESPONSE_FLAG) != 0;
+    bool isConfirmation = !isResponse && length > DPA_ERRN_POS
+        && data[DPA_ERRN_POS] == DPA_STATUS_CONFIRMATION;
+
+    std::vector<Transaction*> finished;
+    bool matched = false;
+    {
+        std::lock_guard<std::mutex> lck(csTransactions);
+        auto pending = pendingTable.find(messageKey(data));
+        if (pending != pendingTable.end()) {
+            Transaction* transaction = pending->second;
+
+            // confirmation belongs to the oldest not yet confirmed request
+            if (isConfirmation) {
+                while (transaction != NULL && !transaction->result.confirmation.empty())
+                    transaction = transaction->keyNext;
+            }
+
+            if (transaction != NULL && (isResponse || isConfirmation)) {
+                matched = true;
+                if (isConfirmation)
+                    transaction->result.confirmation.assign(data, length);
+                else
+                    transaction->result.response.assign(data, length);
+
+                if (isResponse || transaction->broadcast) {
+                    removeTransaction(transaction);
+                    finished.push_back(transaction);
+                }
+            }
+        }
+    }
+
+    if (matched) {
+        finishTransactions(finished);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lck(csUnmatchedListener);
+    if (unmatchedListener)
+        unmatchedListener(data, length);
+}
+
+/*
+ * Function of timer thread. Advances timer wheel by ticks and times out
+ * transactions in reached slots. Sleeps, while no transaction is pending.
+ */
+void CDCTransactionsPrivate::timerThread(void)
+{
+    std::unique_lock<std::mutex> lck(csTransactions);
+    processedTick = currentTick();
+
+    while (timerRunning) {
+        if (pendingCount == 0) {
+            // processed tick is moved by the first added transaction
+            timerCond.wait(lck, [this] { return !timerRunning || pendingCount != 0; });
+            continue;
+        }
+
+        timerCond.wait_until(lck, startTime + (processedTick + 1) * tickInterval);
+
+        std::vector<Transaction*> finished;
+        unsigned long long nowTick = currentTick();
+        for (; processedTick < nowTick; processedTick++) {
+            Transaction* transaction = wheel[(processedTick + 1) & (WHEEL_SIZE - 1)];
+            while (transaction != NULL) {
+                // transactions of later rounds stay in the slot
+                Transaction* next = transaction->wheelNext;
+                if (transaction->deadlineTick <= processedTick + 1) {
+                    removeTransaction(transaction);
+                    transaction->result.status = TransactionStatus::TIMEOUT;
+                    finished.push_back(transaction);
+                }
+                transaction = next;
+            }
+        }
+
+        if (!finished.empty()) {
+            lck.unlock();
+            finishTransactions(finished);
+            lck.lock();
+        }
+    }
+}
+
+void CDCTransactionsPrivate::finishTransactions(std::vector<Transaction*>& finished)
+{
+    for (Transaction* transaction : finished) {
+        if (transaction->callback)
+            transaction->callback(transaction->result);
+        delete transaction;
+    }
+    finished.clear();
+}
+
+
+/* --- PUBLIC INTERFACE */
+CDCTransactions::CDCTransactions(CDCImpl& cdc, unsigned int tickInterval)
+{
+    implObj = ant_new CDCTransactionsPrivate(cdc, tickInterval);
+
+    CDCTransactionsPrivate* impl = implObj;
+    impl->listenerId = cdc.addAsyncMsgListener([impl](unsigned char* data, unsigned int length) {
+        impl->processAsyncMessage(data, length);
+    });
+}
+
+CDCTransactions::~CDCTransactions()
+{
+    // waits for running listener call
+    implObj->cdc.removeAsyncMsgListener(implObj->listenerId);
+    delete implObj;
+}
+
+std::future<TransactionResult> CDCTransactions::send(const ustring& request, unsigned int timeout)
+{
+    std::shared_ptr<std::promise<TransactionResult>> promise = std::make_shared<std::promise<TransactionResult>>();
+    std::future<TransactionResult> future = promise->get_future();
+
+    send(request, timeout, [promise](const TransactionResult& result) {
+        promise->set_value(result);
+    });
+    return future;
+}
+
+void CDCTransactions::send(const ustring& request, unsigned int timeout, TransactionCallbackF callback)
+{
+    if (request.size() < DPA_REQUEST_HEADER) {
+        TransactionResult result;
+        result.status = TransactionStatus::INVALID_REQUEST;
+        result.dsResponse = ERR;
+        if (callback)
+            callback(result);
+        return;
+    }
+
+    unsigned long long id = implObj->addTransaction(request, timeout, callback);
+
+    CDCResult<DSResponse> dsResult = implObj->cdc.trySendData(request);
+    // failed DS command has no response, it must not look accepted
+    if (!dsResult || dsResult.value() != OK) {
+        implObj->failTransaction(CDCTransactionsPrivate::messageKey(request.data()), id,
+            dsResult, dsResult? dsResult.value() : ERR);
+    }
+}
+
+unsigned int CDCTransactions::getPendingCount(void)
+{
+    std::lock_guard<std::mutex> lck(implObj->csTransactions);
+    return implObj->pendingCount;
+}
+
+void CDCTransactions::setUnmatchedListener(AsyncMsgListenerF unmatchedListener)
+{
+    std::lock_guard<std::mutex> lck(implObj->csUnmatchedListener);
+    implObj->unmatchedListener = unmatchedListener;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 IQRF Tech s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <CDCTransport.h>
+
+CDCFdTransport::CDCFdTransport(int fd, bool ownsFd)
+    :fd(fd), ownsFd(ownsFd)
+{
+}
+
+CDCFdTransport::~CDCFdTransport()
+{
+    if (ownsFd)
+        close(fd);
+}
+
+int CDCFdTransport::getHandle(void)
+{
+    return fd;
+}
+
+int CDCFdTransport::read(unsigned char* buf, unsigned int buflen)
+{
+    return static_cast<int>(::read(fd, buf, buflen));
+}
+
+int CDCFdTransport::write(const unsigned char* data, unsigned int dlen)
+{
+    return static_cast<int>(::write(fd, data, dlen));
+}